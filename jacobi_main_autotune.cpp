@@ -0,0 +1,82 @@
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include "autotuneJacobi.h"
+
+using namespace std;
+
+int main(int argc, char * argv[]){
+
+    int n_iterations = 0;
+    int dim_matrix = 0;
+    int retune = 0;
+    int show_result = 0;
+
+    //check if exist the first argument to set number of iterations
+    if(argv[1] == NULL){
+        n_iterations = 500;
+        dim_matrix = 1000;
+        retune = 0;
+        show_result = 0;
+    }
+    else{
+        if(argv[1] == "help" || argv[1][0] == 'H' || argv[1][0] == 'h'){
+            cout<<"--- Help ---"<<endl;
+            cout<<"./jacobi_auto n_iterations dim_matrix retune show_result"<<endl;
+            cout<<"Parameters:"<<endl;
+            cout<<"n_iterations: set number of iterations (DEFAULT: 500)"<<endl;
+            cout<<"dim_matrix: set dimension of matrix (nxn) (DEFAULT: 1000)"<<endl;
+            cout<<"retune: set an integer flag to run the probes even if the tuning cache has an entry (DEFAULT: 0)"<<endl;
+            cout<<"show_result: set an integer flag to visualize the algorithm result (DEFAULT: 0)"<<endl;
+            return 0;
+        }
+        else
+            n_iterations = (atoi(argv[1]) < 1) ? 500 : atoi(argv[1]);
+    }
+
+    //check if exist the second argument to set dimension of matrix
+    if(argc < 3)
+        dim_matrix = 1000;
+    else
+        dim_matrix = (atoi(argv[2]) <= 1) ? 1000 : atoi(argv[2]);
+
+    //check if exist the third argument to set the retune flag
+    if(argc < 4)
+        retune = 0;
+    else
+        retune = (atoi(argv[3]) != 0 && atoi(argv[3]) != 1) ? 0 : atoi(argv[3]);
+
+    //check if exist the last argument to set flag to show the result of algorithm
+    if(argc < 5)
+        show_result = 0;
+    else
+        show_result = (atoi(argv[4]) != 0 && atoi(argv[4]) != 1) ? 0 : atoi(argv[4]);
+
+    string path = tuningCachePath();
+    if(retune == 1){
+        cout<<"Autotuning"<<endl;
+        autotune(dim_matrix, min(n_iterations, 20), path);
+    }
+
+    //generate matrix and vector random
+    vector<vector<float>> A(dim_matrix, vector<float>(dim_matrix,0));
+    vector<float> b(dim_matrix);
+    A=matrixGenerator(dim_matrix);
+    b=RHSVectorGenerator(dim_matrix);
+
+    long time_auto;                 //variable for the time of the chosen engine
+    tuningChoice choice;
+
+    vector<float> res=autoJacobi(n_iterations, dim_matrix, A, b, &time_auto, &choice);
+
+    cout<<"Engine: "<<choice.engine<<" with "<<choice.n_threads<<" threads (size class "<<sizeClass(dim_matrix)<<", cache "<<path<<")"<<endl;
+    cout<<"Row kernel: "<<choice.kernel<<" (tiles "<<engineKernel().tiles.cols<<"x"<<engineKernel().tiles.rows<<"), barrier: "<<choice.barrier<<endl;
+
+    if (show_result == 1){
+    	cout<<endl<<"Results: "<<endl;
+    	printResult(res);
+    }
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include "batchJacobi.h"
+
+using namespace std;
+
+int main(int argc, char * argv[]){
+
+    int n_iterations = 0;
+    int dim_matrix = 0;
+    int n_systems = 0;
+    int n_threads = 0;
+    int show_result = 0;
+
+    //check if exist the first argument to set number of iterations
+    if(argv[1] == NULL){
+        n_iterations = 500;
+        dim_matrix = 16;
+        n_systems = 10000;
+        n_threads = 2;
+        show_result = 0;
+    }
+    else{
+        if(argv[1] == "help" || argv[1][0] == 'H' || argv[1][0] == 'h'){
+            cout<<"--- Help ---"<<endl;
+            cout<<"./jacobi_batch n_iterations dim_matrix n_systems n_threads show_result"<<endl;
+            cout<<"Parameters:"<<endl;
+            cout<<"n_iterations: set number of iterations (DEFAULT: 500)"<<endl;
+            cout<<"dim_matrix: set dimension of each matrix (nxn) (DEFAULT: 16)"<<endl;
+            cout<<"n_systems: set number of independent systems (DEFAULT: 10000)"<<endl;
+            cout<<"n_threads: set number of thread (DEFAULT: 2)"<<endl;
+            cout<<"show_result: set an integer flag to visualize the result of the first system (DEFAULT: 0)"<<endl;
+            return 0;
+        }
+        else
+            n_iterations = (atoi(argv[1]) < 1) ? 500 : atoi(argv[1]);
+    }
+
+    //check if exist the second argument to set dimension of matrix
+    if(argc < 3)
+        dim_matrix = 16;
+    else
+        dim_matrix = (atoi(argv[2]) <= 1) ? 16 : atoi(argv[2]);
+
+    //check if exist the third argument to set number of systems
+    if(argc < 4)
+        n_systems = 10000;
+    else
+        n_systems = (atoi(argv[3]) < 1) ? 10000 : atoi(argv[3]);
+
+    //check if exist the fourth argument to set number of threads
+    if(argc < 5)
+        n_threads = 2;
+    else
+        n_threads = (atoi(argv[4]) < 1) ? 2 : atoi(argv[4]);
+
+    //check if exist the last argument to set flag to show the result of algorithm
+    if(argc < 6)
+        show_result = 0;
+    else
+        show_result = (atoi(argv[5]) != 0 && atoi(argv[5]) != 1) ? 0 : atoi(argv[5]);
+
+    //generate the batch of random systems
+    vector<float> A((size_t)n_systems * dim_matrix * dim_matrix);
+    vector<float> b((size_t)n_systems * dim_matrix);
+    for(int s=0; s<n_systems; s++){
+        //matrix first, then vector, as in the other drivers
+        vector<vector<float>> As = matrixGenerator(dim_matrix);
+        vector<float> bs = RHSVectorGenerator(dim_matrix);
+        packSystem(s, dim_matrix, As, bs, A, b);
+    }
+
+    long time_batch1;               //variable for batch time (n_threads=1)
+    long time_batchN;               //variable for batch time (n_threads>1)
+    vector<int> nIter;
+
+    cout<<"Batch execution"<<endl;
+    vector<float> res1=batchJacobi(n_iterations, dim_matrix, n_systems, 1, A, b, &time_batch1, NULL);
+    vector<float> resN=batchJacobi(n_iterations, dim_matrix, n_systems, n_threads, A, b, &time_batchN, &nIter);
+
+    cout<<"Throughput (1 thread): "<<(double)n_systems * 1e6 / time_batch1<<" solves/s"<<endl;
+    cout<<"Throughput ("<<n_threads<<" threads): "<<(double)n_systems * 1e6 / time_batchN<<" solves/s"<<endl;
+    cout<<"Scalability: "<<scalability(time_batch1, time_batchN)<<endl;
+
+    if (show_result == 1){
+    	cout<<endl<<"Results of the first system: "<<endl;
+    	printResult(vector<float>(resN.begin(), resN.begin() + dim_matrix));
+    	cout<<"Computed with "<< nIter[0] <<" iterations."<<endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+#include <vector>
+#include <barrier>
+#include <chrono>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <thread>
+
+#include "utilities.h"
+#include "arena.h"
+#include "blockedKernel.h"
+#include "fixedJacobi.h"
+#include "spinBarrier.h"
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#define BENCH_TBB
+#endif
+#if __has_include(<ff/parallel_for.hpp>)
+#include <ff/parallel_for.hpp>
+#define BENCH_FASTFLOW
+#endif
+
+using namespace std;
+
+/**
+ * @brief Best time per call (ns) of f over three rounds of at least 0.1 s each.
+ */
+double bench(const function<void()> &f){
+    using clock = chrono::steady_clock;
+    f();    //warm up caches and page tables
+
+    double best = 1e300;
+    for(int round=0; round<3; round++){
+        long calls = 0;
+        auto start = clock::now();
+        double elapsed;
+        do{
+            f();
+            calls++;
+            elapsed = chrono::duration<double, nano>(clock::now() - start).count();
+        } while(elapsed < 1e8);
+        best = min(best, elapsed / calls);
+    }
+    return best;
+}
+
+double roofline = 0;    //single-core STREAM triad bandwidth in GB/s
+
+/**
+ * @brief Print a result line: ns per call, bandwidth, flop rate and share of the roofline.
+ */
+void report(const string &name, const string &param, double ns, double bytes, double flops){
+    cout << left << setw(26) << name << setw(14) << param << right << fixed << setprecision(1)
+         << setw(14) << ns << " ns/op";
+    if(bytes > 0)
+        cout << setw(10) << bytes / ns << " GB/s";
+    if(flops > 0)
+        cout << setw(10) << flops / ns << " GFLOP/s";
+    if(bytes > 0 && roofline > 0)
+        cout << setw(8) << 100 * bytes / ns / roofline << " % roof";
+    cout << endl;
+}
+
+/**
+ * @brief Off-diagonal sums of all the rows with the plain loop of the original engines.
+ */
+#define PLAIN_ROW_SUMS                                              \
+    for(int i=0; i<n; i++){                                         \
+        const float *row = M.row(i);                                \
+        float s = 0;                                                \
+        for(int j=0; j<i; j++)                                      \
+            s += row[j]*x[j];                                       \
+        for(int j=i+1; j<n; j++)                                    \
+            s += row[j]*x[j];                                       \
+        sum[i] = s;                                                 \
+    }
+
+void plainRowSums(const arenaMatrix &M, int n, const float *x, float *sum){
+    PLAIN_ROW_SUMS
+}
+
+/**
+ * @brief Time per round of n_threads threads going through a barrier.
+ *
+ *        The first thread reads the clock after a start barrier, when all the threads
+ *        exist, and after an end barrier, so their creation and join are not counted.
+ */
+template<typename Barrier>
+double barrierRound(int n_threads, int rounds){
+    Barrier bar(n_threads);
+    barrier<> sync(n_threads);
+    chrono::steady_clock::time_point start, stop;
+    vector<thread> t;
+    for(int i=0; i<n_threads; i++)
+        t.emplace_back([&, i](){
+            sync.arrive_and_wait();
+            if(i == 0)
+                start = chrono::steady_clock::now();
+            for(int r=0; r<rounds; r++)
+                bar.arrive_and_wait();
+            sync.arrive_and_wait();
+            if(i == 0)
+                stop = chrono::steady_clock::now();
+        });
+    for(thread &th : t)
+        th.join();
+    return chrono::duration<double, nano>(stop - start).count() / rounds;
+}
+
+int main(int argc, char * argv[]){
+
+    int max_threads = 0;
+    int stream_mb = 0;
+
+    //check if exist the first argument to set the maximum number of threads
+    if(argv[1] == NULL){
+        max_threads = max(2, (int) thread::hardware_concurrency());
+        stream_mb = 64;
+    }
+    else{
+        if(argv[1] == "help" || argv[1][0] == 'H' || argv[1][0] == 'h'){
+            cout<<"--- Help ---"<<endl;
+            cout<<"./jacobi_bench max_threads stream_mb"<<endl;
+            cout<<"Parameters:"<<endl;
+            cout<<"max_threads: set the maximum number of threads of the barrier benchmarks (DEFAULT: hardware threads)"<<endl;
+            cout<<"stream_mb: set the size in MB of each array of the bandwidth benchmark (DEFAULT: 64)"<<endl;
+            return 0;
+        }
+        else
+            max_threads = (atoi(argv[1]) < 1) ? max(2, (int) thread::hardware_concurrency()) : atoi(argv[1]);
+    }
+
+    //check if exist the last argument to set the size of the bandwidth benchmark
+    if(argc < 3)
+        stream_mb = 64;
+    else
+        stream_mb = (atoi(argv[2]) < 1) ? 64 : atoi(argv[2]);
+
+    //STREAM triad on one thread, the bandwidth roofline of the single-threaded kernels
+    {
+        size_t n = (size_t) stream_mb * (1 << 20) / sizeof(float);
+        arenaBuffer a(n), b(n), c(n);
+        for(size_t i=0; i<n; i++){
+            b[i] = 1;
+            c[i] = 2;
+        }
+        double ns = bench([&](){
+            for(size_t i=0; i<n; i++)
+                a[i] = b[i] + 3.0f*c[i];
+        });
+        roofline = 3.0 * n * sizeof(float) / ns;
+        report("stream triad 1 thread", to_string(stream_mb) + " MB", ns, 3.0 * n * sizeof(float), 2.0 * n);
+    }
+
+    //row-update kernels: bytes are the matrix streamed once, two flops per entry
+    cout << endl;
+    for(int n : {64, 512, 2048, 8192}){
+        vector<vector<float>> A = matrixGenerator(n);
+        arenaMatrix M(A);
+        arenaBuffer x(n), sum(n);
+        for(int i=0; i<n; i++)
+            x[i] = 0.5f;
+        double bytes = (double) n * n * sizeof(float);
+        double flops = 2.0 * n * n;
+        string param = "n=" + to_string(n);
+
+        report("row sums plain", param, bench([&](){ plainRowSums(M, n, x.data(), sum.data()); }), bytes, flops);
+        report("row sums simd", param, bench([&](){ simdRowSums(M, 0, n, x.data(), sum.data()); }), bytes, flops);
+#if defined(__x86_64__)
+        if(__builtin_cpu_supports("avx2"))
+            report("row sums simd avx2", param, bench([&](){ simdRowSumsAVX2(M, 0, n, x.data(), sum.data()); }), bytes, flops);
+        if(__builtin_cpu_supports("avx512f"))
+            report("row sums simd avx512", param, bench([&](){ simdRowSumsAVX512(M, 0, n, x.data(), sum.data()); }), bytes, flops);
+#endif
+        report("row sums blocked", param, bench([&](){ blockedRowSums(M, 0, n, x.data(), sum.data(), cacheTiles()); }), bytes, flops);
+
+        if(n == 64){
+            //iterations of the fixed-size kernel, never converging so that the setup is amortized
+            const int iters = 200;
+            vector<float> flat(n * n), rhs(n, 1), guess(n);
+            for(int i=0; i<n; i++)
+                for(int j=0; j<n; j++)
+                    flat[i * n + j] = A[i][j];
+            int it;
+            double ns = bench([&](){ fixedJacobiDispatch(iters, n, flat.data(), rhs.data(), guess.data(), &it, -1); });
+            //the matrix stays in the cache across the iterations, the bandwidth is not a memory figure
+            report("fixed kernel per iter", param + " in cache", ns / iters, 0, flops);
+        }
+    }
+
+    //partial-norm reduction and iterate copy/swap
+    cout << endl;
+    for(int n : {1000, 100000, 10000000}){
+        arenaBuffer old_value(n);
+        vector<float> new_value(n, 1);
+        string param = "n=" + to_string(n);
+
+        float norm = 0;
+        report("norm reduction", param, bench([&](){
+            float s = 0;
+            for(int i=0; i<n; i++)
+                s += abs(old_value[i] - new_value[i]);
+            norm += s;
+        }), 2.0 * n * sizeof(float), 2.0 * n);
+        report("iterate copy", param, bench([&](){ copy(new_value.begin(), new_value.end(), old_value.data()); }), 2.0 * n * sizeof(float), 0);
+
+        vector<float> other(n, 2);
+        report("iterate swap", param, bench([&](){ new_value.swap(other); }), 0, 0);
+        if(norm < 0)
+            cout << norm;
+    }
+
+    //barrier round trip
+    cout << endl;
+    for(int t=1; t<=max_threads; t*=2){
+        int rounds = 20000 / t;
+        string param = to_string(t) + " threads";
+        report("std::barrier round", param, barrierRound<barrier<>>(t, rounds), 0, 0);
+        report("spin barrier round", param, barrierRound<spinBarrier<>>(t, rounds), 0, 0);
+    }
+
+    //barrier callback: sum of the partial norms of the threads
+    {
+        const int NORM_STRIDE = CACHE_LINE / sizeof(float);
+        arenaBuffer partial(max_threads * NORM_STRIDE);
+        float total = 0;
+        report("partial norm sum", to_string(max_threads) + " threads", bench([&](){
+            for(int i=0; i<max_threads; i++){
+                total += partial[i * NORM_STRIDE];
+                partial[i * NORM_STRIDE] = 0;
+            }
+        }), 0, 0);
+        if(total < 0)
+            cout << total;
+    }
+
+    //dispatch overhead of an empty parallel algorithm, with one block per thread
+    cout << endl;
+    for(int t=1; t<=max_threads; t*=2){
+#ifdef BENCH_TBB
+        tbb::global_control workers(tbb::global_control::max_allowed_parallelism, t);
+#endif
+        vector<int> blocks(t);
+        report("par_unseq dispatch", to_string(t) + " threads", bench([&](){
+            transform_reduce(execution::par_unseq, blocks.begin(), blocks.end(), 0.0f, plus<float>(), [](int i){ return (float) i; });
+        }), 0, 0);
+    }
+
+#ifdef BENCH_FASTFLOW
+    //dispatch overhead of an empty parallel_for
+    for(int t=1; t<=max_threads; t*=2){
+        ff::ParallelFor parallelCycle(t, true);
+        report("ff parallel_for dispatch", to_string(t) + " threads", bench([&](){
+            parallelCycle.parallel_for(0, t, 1, 0, [&](const long i){}, t);
+        }), 0, 0);
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include "checkpointJacobi.h"
+
+using namespace std;
+
+int main(int argc, char * argv[]){
+
+    int n_iterations = 0;
+    int dim_matrix = 0;
+    int n_threads = 0;
+    int checkpoint_every = 0;
+    int restart = 0;
+    string path = "jacobi.ckpt";
+
+    //check if exist the first argument to set number of iterations
+    if(argv[1] == NULL){
+        n_iterations = 500;
+        dim_matrix = 1000;
+        n_threads = 2;
+        checkpoint_every = 10;
+        restart = 0;
+    }
+    else{
+        if(argv[1] == "help" || argv[1][0] == 'H' || argv[1][0] == 'h'){
+            cout<<"--- Help ---"<<endl;
+            cout<<"./jacobi_checkpoint n_iterations dim_matrix n_threads checkpoint_every restart checkpoint_file"<<endl;
+            cout<<"Parameters:"<<endl;
+            cout<<"n_iterations: set number of iterations (DEFAULT: 500)"<<endl;
+            cout<<"dim_matrix: set dimension of matrix (nxn) (DEFAULT: 1000)"<<endl;
+            cout<<"n_threads: set number of thread (DEFAULT: 2)"<<endl;
+            cout<<"checkpoint_every: set number of iterations between two checkpoints (DEFAULT: 10)"<<endl;
+            cout<<"restart: set an integer flag to resume from the checkpoint file (DEFAULT: 0)"<<endl;
+            cout<<"checkpoint_file: set the checkpoint file (DEFAULT: jacobi.ckpt)"<<endl;
+            return 0;
+        }
+        else
+            n_iterations = (atoi(argv[1]) < 1) ? 500 : atoi(argv[1]);
+    }
+
+    //check if exist the second argument to set dimension of matrix
+    if(argc < 3)
+        dim_matrix = 1000;
+    else
+        dim_matrix = (atoi(argv[2]) <= 1) ? 1000 : atoi(argv[2]);
+
+    //check if exist the third argument to set number of threads
+    if(argc < 4)
+        n_threads = 2;
+    else
+        n_threads = (atoi(argv[3]) < 1) ? 2 : atoi(argv[3]);
+
+    //check if exist the fourth argument to set the checkpoint period
+    if(argc < 5)
+        checkpoint_every = 10;
+    else
+        checkpoint_every = (atoi(argv[4]) < 1) ? 10 : atoi(argv[4]);
+
+    //check if exist the fifth argument to set the restart flag
+    if(argc < 6)
+        restart = 0;
+    else
+        restart = (atoi(argv[5]) != 0 && atoi(argv[5]) != 1) ? 0 : atoi(argv[5]);
+
+    //check if exist the last argument to set the checkpoint file
+    if(argc >= 7)
+        path = argv[6];
+
+    //generate matrix and vector random, rand() is not seeded so a restart gets the same system
+    vector<vector<float>> A(dim_matrix, vector<float>(dim_matrix,0));
+    vector<float> b(dim_matrix);
+    A=matrixGenerator(dim_matrix);
+    b=RHSVectorGenerator(dim_matrix);
+
+    long time_par;                  //variable for threads time
+    int nIter = n_iterations;       //variable to store number of iterations done
+
+    cout<<"Parallel execution with checkpoints"<<endl;
+    vector<float> res=checkpointJacobi(n_iterations, dim_matrix, n_threads, A, b, &time_par, path, checkpoint_every, restart == 1, &nIter);
+
+    cout<<"Computed with "<< nIter <<" iterations, checkpoint in "<< path <<endl;
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include "sequentialJacobi.h"
+#include "distributedJacobi.h"
+
+using namespace std;
+
+int main(int argc, char * argv[]){
+
+    int n_iterations = 0;
+    int dim_matrix = 0;
+    int n_ranks = 0;
+    string transport = "shm";
+    int show_result = 0;
+
+    //check if exist the first argument to set number of iterations
+    if(argv[1] == NULL){
+        n_iterations = 500;
+        dim_matrix = 1000;
+        n_ranks = 2;
+        show_result = 0;
+    }
+    else{
+        if(argv[1] == "help" || argv[1][0] == 'H' || argv[1][0] == 'h'){
+            cout<<"--- Help ---"<<endl;
+            cout<<"./jacobi_dist n_iterations dim_matrix n_ranks transport show_result"<<endl;
+            cout<<"Parameters:"<<endl;
+            cout<<"n_iterations: set number of iterations (DEFAULT: 500)"<<endl;
+            cout<<"dim_matrix: set dimension of matrix (nxn) (DEFAULT: 1000)"<<endl;
+            cout<<"n_ranks: set number of processes (DEFAULT: 2)"<<endl;
+            cout<<"transport: set the transport between the processes, shm or socket (DEFAULT: shm)"<<endl;
+            cout<<"show_result: set an integer flag to visualize the algorithm result (DEFAULT: 0)"<<endl;
+            return 0;
+        }
+        else
+            n_iterations = (atoi(argv[1]) < 1) ? 500 : atoi(argv[1]);
+    }
+
+    //check if exist the second argument to set dimension of matrix
+    if(argc < 3)
+        dim_matrix = 1000;
+    else
+        dim_matrix = (atoi(argv[2]) <= 1) ? 1000 : atoi(argv[2]);
+
+    //check if exist the third argument to set number of processes
+    if(argc < 4)
+        n_ranks = 2;
+    else
+        n_ranks = (atoi(argv[3]) < 1) ? 2 : atoi(argv[3]);
+
+    //check if exist the fourth argument to set the transport
+    if(argc >= 5)
+        transport = (string(argv[4]) == "socket") ? "socket" : "shm";
+
+    //check if exist the last argument to set flag to show the result of algorithm
+    if(argc < 6)
+        show_result = 0;
+    else
+        show_result = (atoi(argv[5]) != 0 && atoi(argv[5]) != 1) ? 0 : atoi(argv[5]);
+
+    //generate matrix and vector random
+    vector<vector<float>> A(dim_matrix, vector<float>(dim_matrix,0));
+    vector<float> b(dim_matrix);
+    A=matrixGenerator(dim_matrix);
+    b=RHSVectorGenerator(dim_matrix);
+
+    long time_seq;                  //variable for sequence time
+    long time_distN;                //variable for distributed time (n_ranks>1)
+    long time_dist1;                //variable for distributed time (n_ranks=1)
+    int nIter = n_iterations;
+    int nIterDist = 0;              //iterations of the n_ranks run
+    int nIterDist1 = 0;             //iterations of the 1 rank run
+
+    vector<float> resSeq=seqJacobi(n_iterations, dim_matrix, A, b, &time_seq, &nIter);
+
+    cout<<"Distributed execution ("<<transport<<")"<<endl;
+    vector<float> resDistN=distributedJacobi(n_iterations, dim_matrix, n_ranks, A, b, &time_distN, transport, &nIterDist);
+    if(resDistN.empty()){
+        std::cerr << "Distributed execution with " << n_ranks << " ranks failed\n";
+        return EXIT_FAILURE;
+    }
+    vector<float> resDist1=distributedJacobi(n_iterations, dim_matrix, 1, A, b, &time_dist1, transport, &nIterDist1);
+    if(resDist1.empty()){
+        std::cerr << "Distributed execution with 1 rank failed\n";
+        return EXIT_FAILURE;
+    }
+
+    cout<<"Speedup: "<<speedup(time_seq, time_distN)<<endl;
+    cout<<"Scalability: "<<scalability(time_dist1, time_distN)<<endl;
+    cout<<"Efficiency: "<<efficiency(time_seq, time_distN, n_ranks)<<endl;
+
+    if (show_result == 1){
+    	cout<<endl<<"Results: "<<endl;
+    	printResult(resDistN);
+    	cout<<"Computed with "<< nIterDist <<" iterations."<<endl;
+    }
+
+    return 0;
+}
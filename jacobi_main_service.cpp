@@ -0,0 +1,87 @@
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include "solveService.h"
+
+using namespace std;
+
+int main(int argc, char * argv[]){
+
+    int n_jobs = 0;
+    int dim_small = 0;
+    int dim_large = 0;
+    int n_workers = 0;
+
+    //check if exist the first argument to set number of jobs
+    if(argv[1] == NULL){
+        n_jobs = 2000;
+        dim_small = 16;
+        dim_large = 1000;
+        n_workers = 2;
+    }
+    else{
+        if(argv[1] == "help" || argv[1][0] == 'H' || argv[1][0] == 'h'){
+            cout<<"--- Help ---"<<endl;
+            cout<<"./jacobi_service n_jobs dim_small dim_large n_workers"<<endl;
+            cout<<"Parameters:"<<endl;
+            cout<<"n_jobs: set number of small jobs, one large job is submitted every 500 (DEFAULT: 2000)"<<endl;
+            cout<<"dim_small: set dimension of the small matrices (DEFAULT: 16)"<<endl;
+            cout<<"dim_large: set dimension of the large matrices (DEFAULT: 1000)"<<endl;
+            cout<<"n_workers: set number of workers of the pool (DEFAULT: 2)"<<endl;
+            return 0;
+        }
+        else
+            n_jobs = (atoi(argv[1]) < 1) ? 2000 : atoi(argv[1]);
+    }
+
+    //check if exist the second argument to set dimension of the small matrices
+    if(argc < 3)
+        dim_small = 16;
+    else
+        dim_small = (atoi(argv[2]) <= 1) ? 16 : atoi(argv[2]);
+
+    //check if exist the third argument to set dimension of the large matrices
+    if(argc < 4)
+        dim_large = 1000;
+    else
+        dim_large = (atoi(argv[3]) <= 1) ? 1000 : atoi(argv[3]);
+
+    //check if exist the last argument to set number of workers
+    if(argc < 5)
+        n_workers = 2;
+    else
+        n_workers = (atoi(argv[4]) < 1) ? 2 : atoi(argv[4]);
+
+    //a few systems reused by the jobs, generating them is not part of the service
+    vector<vector<float>> smallA = matrixGenerator(dim_small);
+    vector<float> smallB = RHSVectorGenerator(dim_small);
+    vector<vector<float>> largeA = matrixGenerator(dim_large);
+    vector<float> largeB = RHSVectorGenerator(dim_large);
+
+    long time_service;              //variable for service time
+    solveService::statistics s;
+
+    cout<<"Solve service with "<<n_workers<<" workers"<<endl;
+    {
+        utimer servicetime("Elapsed service time = ", &time_service);
+
+        solveService service(n_workers, min(dim_large, 512));
+        vector<future<vector<float>>> results;
+        for(int k=0; k<n_jobs; k++){
+            if(k % 500 == 0)
+                results.push_back(service.submit(largeA, largeB, 500));
+            results.push_back(service.submit(smallA, smallB, 500, EPSILON, k % 2));
+        }
+
+        for(auto &r : results)
+            r.get();
+        s = service.stats();
+    }
+
+    cout<<"Completed jobs: "<<s.completed<<", queue depth: "<<s.queueDepth<<endl;
+    cout<<"Throughput: "<<s.throughput<<" jobs/s"<<endl;
+    cout<<"Latency p50/p95/p99: "<<s.p50<<" / "<<s.p95<<" / "<<s.p99<<" usec"<<endl;
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include "sequentialJacobi.h"
+#include "symmetricJacobi.h"
+
+using namespace std;
+
+int main(int argc, char * argv[]){
+
+    int n_iterations = 0;
+    int dim_matrix = 0;
+    int n_threads = 0;
+    int show_result = 0;
+
+    //check if exist the first argument to set number of iterations
+    if(argv[1] == NULL){
+        n_iterations = 500;
+        dim_matrix = 1000;
+        n_threads = 2;
+        show_result = 0;
+    }
+    else{
+        if(argv[1] == "help" || argv[1][0] == 'H' || argv[1][0] == 'h'){
+            cout<<"--- Help ---"<<endl;
+            cout<<"./jacobi_sym n_iterations dim_matrix n_threads show_result"<<endl;
+            cout<<"Parameters:"<<endl;
+            cout<<"n_iterations: set number of iterations (DEFAULT: 500)"<<endl;
+            cout<<"dim_matrix: set dimension of matrix (nxn) (DEFAULT: 1000)"<<endl;
+            cout<<"n_threads: set number of thread (DEFAULT: 2)"<<endl;
+            cout<<"show_result: set an integer flag to visualize the algorithm result (DEFAULT: 0)"<<endl;
+            return 0;
+        }
+        else
+            n_iterations = (atoi(argv[1]) < 1) ? 500 : atoi(argv[1]);
+    }
+
+    //check if exist the second argument to set dimension of matrix
+    if(argc < 3)
+        dim_matrix = 1000;
+    else
+        dim_matrix = (atoi(argv[2]) <= 1) ? 1000 : atoi(argv[2]);
+
+    //check if exist the third argument to set number of threads
+    if(argc < 4)
+        n_threads = 2;
+    else
+        n_threads = (atoi(argv[3]) < 1) ? 2 : atoi(argv[3]);
+
+    //check if exist the last argument to set flag to show the result of algorithm
+    if(argc < 5)
+        show_result = 0;
+    else
+        show_result = (atoi(argv[4]) != 0 && atoi(argv[4]) != 1) ? 0 : atoi(argv[4]);
+
+    //generate symmetric matrix and vector random
+    vector<vector<float>> A=symmetricMatrixGenerator(dim_matrix);
+    vector<float> b=RHSVectorGenerator(dim_matrix);
+    symPackedMatrix P(A);
+
+    long time_seq;                  //variable for sequence time (full storage)
+    long time_sym;                  //variable for sequence time (packed storage)
+    long time_symN;                 //variable for threads time (n_threads>1)
+    long time_sym1;                 //variable for threads time (n_threads=1)
+    int nIter = n_iterations;
+    int nIterSym = n_iterations;
+
+    vector<float> resSeq=seqJacobi(n_iterations, dim_matrix, A, b, &time_seq, &nIter);
+
+    cout<<"Symmetric packed execution ("<<P.storage() * sizeof(float) / 1024<<" KB instead of "
+        <<(size_t) dim_matrix * dim_matrix * sizeof(float) / 1024<<" KB)"<<endl;
+    vector<float> resSym=seqSymJacobi(n_iterations, dim_matrix, P, b, &time_sym, &nIterSym);
+    vector<float> resSymN=parallelSymJacobi(n_iterations, dim_matrix, n_threads, P, b, &time_symN);
+    vector<float> resSym1=parallelSymJacobi(n_iterations, dim_matrix, 1, P, b, &time_sym1);
+
+    cout<<"Speedup (packed sequential): "<<speedup(time_seq, time_sym)<<endl;
+    cout<<"Speedup: "<<speedup(time_seq, time_symN)<<endl;
+    cout<<"Scalability: "<<scalability(time_sym1, time_symN)<<endl;
+    cout<<"Efficiency: "<<efficiency(time_seq, time_symN, n_threads)<<endl;
+
+    if (show_result == 1){
+    	cout<<endl<<"Results: "<<endl;
+    	printResult(resSymN);
+    	cout<<"Computed with "<< nIterSym <<" iterations."<<endl;
+    }
+
+    return 0;
+}
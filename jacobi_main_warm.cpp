@@ -0,0 +1,96 @@
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include "jacobiSolver.h"
+
+using namespace std;
+
+int main(int argc, char * argv[]){
+
+    int n_iterations = 0;
+    int dim_matrix = 0;
+    int n_updates = 0;
+    int show_result = 0;
+
+    //check if exist the first argument to set number of iterations
+    if(argv[1] == NULL){
+        n_iterations = 500;
+        dim_matrix = 1000;
+        n_updates = 10;
+        show_result = 0;
+    }
+    else{
+        if(argv[1] == "help" || argv[1][0] == 'H' || argv[1][0] == 'h'){
+            cout<<"--- Help ---"<<endl;
+            cout<<"./jacobi_warm n_iterations dim_matrix n_updates show_result"<<endl;
+            cout<<"Parameters:"<<endl;
+            cout<<"n_iterations: set number of iterations (DEFAULT: 500)"<<endl;
+            cout<<"dim_matrix: set dimension of matrix (nxn) (DEFAULT: 1000)"<<endl;
+            cout<<"n_updates: set number of rows of A and entries of b updated before the re-solve (DEFAULT: 10)"<<endl;
+            cout<<"show_result: set an integer flag to visualize the algorithm result (DEFAULT: 0)"<<endl;
+            return 0;
+        }
+        else
+            n_iterations = (atoi(argv[1]) < 1) ? 500 : atoi(argv[1]);
+    }
+
+    //check if exist the second argument to set dimension of matrix
+    if(argc < 3)
+        dim_matrix = 1000;
+    else
+        dim_matrix = (atoi(argv[2]) <= 1) ? 1000 : atoi(argv[2]);
+
+    //check if exist the third argument to set number of updates
+    if(argc < 4)
+        n_updates = 10;
+    else
+        n_updates = (atoi(argv[3]) < 0) ? 10 : min(atoi(argv[3]), dim_matrix);
+
+    //check if exist the last argument to set flag to show the result of algorithm
+    if(argc < 5)
+        show_result = 0;
+    else
+        show_result = (atoi(argv[4]) != 0 && atoi(argv[4]) != 1) ? 0 : atoi(argv[4]);
+
+    //generate matrix and vector random
+    vector<vector<float>> A=matrixGenerator(dim_matrix);
+    vector<float> b=RHSVectorGenerator(dim_matrix);
+
+    long time_first;                //variable for the first solve time
+    long time_cold;                 //variable for the re-solve time from zero
+    long time_warm;                 //variable for the re-solve time from the last iterate
+
+    jacobiSolver warm(A, b);
+    int nIterFirst = warm.solve(n_iterations, &time_first);
+
+    //small update of a few rows of A and of the same entries of b
+    for(int k=0; k<n_updates; k++){
+        int i = rand() % dim_matrix;
+        for(int j=0; j<dim_matrix; j++)
+            if(j != i)
+                A[i][j] *= 1.001f;
+        b[i] *= 1.01f;
+        warm.updateRow(i, A[i]);
+        warm.updateRHS(i, b[i]);
+    }
+
+    cout<<"Re-solve from zero"<<endl;
+    jacobiSolver cold(A, b);
+    int nIterCold = cold.solve(n_iterations, &time_cold);
+
+    cout<<"Re-solve from the last iterate"<<endl;
+    int nIterWarm = warm.solve(n_iterations, &time_warm);
+
+    cout<<"Iterations (first solve): "<<nIterFirst<<endl;
+    cout<<"Iterations (cold re-solve): "<<nIterCold<<endl;
+    cout<<"Iterations (warm re-solve): "<<nIterWarm<<endl;
+    cout<<"Speedup: "<<speedup(time_cold, time_warm)<<endl;
+
+    if (show_result == 1){
+    	cout<<endl<<"Results: "<<endl;
+    	printResult(warm.solution());
+    }
+
+    return 0;
+}
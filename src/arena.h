@@ -0,0 +1,235 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include<stdlib.h>
+#include<iostream>
+#include<vector>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <sys/mman.h>
+
+using namespace std;
+
+const size_t CACHE_LINE = 64;
+const size_t HUGE_PAGE_2M = 2UL << 20;
+const size_t HUGE_PAGE_1G = 1UL << 30;
+
+/**
+ * @brief Allocate memory for solver data, backed by huge pages when it is large enough.
+ *
+ *        Blocks of at least 2 MB are mapped with explicit huge pages (1 GB pages if the
+ *        JACOBI_HUGEPAGE_1G environment variable is set and the block is big enough).
+ *        If the system has no reserved huge pages, the block is mapped with normal pages
+ *        and marked with MADV_HUGEPAGE for transparent huge pages. Smaller blocks use
+ *        aligned_alloc. The memory is always aligned to a cache line.
+ *
+ * @param bytes size of the block
+ * @param mapped variable to store the size really reserved (needed to free the block)
+ * @param heap variable to store true if the block comes from aligned_alloc, false if it is mapped
+ * @return pointer to the block, NULL on failure
+ */
+void *arenaAlloc(size_t bytes, size_t *mapped, bool *heap);
+
+/**
+ * @brief Free a block returned by arenaAlloc.
+ *
+ * @param p block
+ * @param mapped reserved size returned by arenaAlloc
+ * @param heap kind of the block returned by arenaAlloc
+ */
+void arenaFree(void *p, size_t mapped, bool heap);
+
+/**
+ * @brief Pool of solver buffers reused across solves.
+ *
+ *        Released blocks are kept and handed out again to the next request of a similar
+ *        size, so repeated solves do not map and fault in their matrix,
+ *        iterate and partial-norm buffers again.
+ */
+class bufferPool {
+  struct block {
+    void *p;
+    size_t mapped;              //reserved size, all of it usable
+    bool heap;                  //kind of the block, for arenaFree
+  };
+
+  mutex m;
+  vector<block> blocks;         //released blocks
+  static const size_t MAX_FREE = 16;
+
+public:
+
+  ~bufferPool();
+
+  /**
+   * @brief Get a block of at least bytes bytes.
+   * @param bytes requested size
+   * @param mapped variable to store the reserved size, to give back with release()
+   * @param heap variable to store the kind of the block, to give back with release()
+   */
+  void *acquire(size_t bytes, size_t *mapped, bool *heap);
+
+  /**
+   * @brief Give back a block obtained by acquire().
+   */
+  void release(void *p, size_t mapped, bool heap);
+};
+
+/**
+ * @brief Process-wide pool used by the solver engines.
+ */
+bufferPool &solverPool();
+
+/**
+ * @brief Float buffer taken from solverPool(), returned to the pool on destruction.
+ */
+class arenaBuffer {
+  float *p;
+  size_t n;
+  size_t mapped;
+  bool heap;
+
+public:
+
+  /**
+   * @param n number of floats, initialized to 0
+   */
+  arenaBuffer(size_t n);
+  ~arenaBuffer();
+
+  arenaBuffer(const arenaBuffer &) = delete;
+  arenaBuffer &operator=(const arenaBuffer &) = delete;
+
+  float *data() const { return p; }
+  size_t size() const { return n; }
+  float &operator[](size_t i) const { return p[i]; }
+};
+
+/**
+ * @brief Contiguous copy of a square matrix in a pooled buffer.
+ *
+ *        Rows are padded to a multiple of a cache line, so every row starts aligned.
+ */
+class arenaMatrix {
+  int n;
+  size_t stride;
+  arenaBuffer buffer;
+
+public:
+
+  /**
+   * @param A matrix
+   */
+  arenaMatrix(const vector<vector<float>> &A);
+
+  /**
+   * @brief Pointer to the row i.
+   */
+  const float *row(int i) const { return buffer.data() + i * stride; }
+
+  int size() const { return n; }
+};
+
+void *arenaAlloc(size_t bytes, size_t *mapped, bool *heap){
+    *heap = bytes < HUGE_PAGE_2M;
+    if(*heap){
+        *mapped = (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+        return aligned_alloc(CACHE_LINE, *mapped);
+    }
+
+    void *p;
+    if(getenv("JACOBI_HUGEPAGE_1G") != NULL && bytes >= HUGE_PAGE_1G){
+        *mapped = (bytes + HUGE_PAGE_1G - 1) / HUGE_PAGE_1G * HUGE_PAGE_1G;
+        p = mmap(NULL, *mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (30 << MAP_HUGE_SHIFT), -1, 0);
+        if(p != MAP_FAILED)
+            return p;
+    }
+
+    *mapped = (bytes + HUGE_PAGE_2M - 1) / HUGE_PAGE_2M * HUGE_PAGE_2M;
+    p = mmap(NULL, *mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if(p != MAP_FAILED)
+        return p;
+
+    //no reserved huge pages: map a 2 MB aligned range and ask for transparent huge pages
+    size_t span = *mapped + HUGE_PAGE_2M;
+    char *base = (char *) mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED)
+        return NULL;
+    char *aligned = (char *) (((uintptr_t) base + HUGE_PAGE_2M - 1) & ~(HUGE_PAGE_2M - 1));
+    if(aligned > base)
+        munmap(base, aligned - base);
+    if(aligned + *mapped < base + span)
+        munmap(aligned + *mapped, base + span - (aligned + *mapped));
+    madvise(aligned, *mapped, MADV_HUGEPAGE);
+    return aligned;
+}
+
+void arenaFree(void *p, size_t mapped, bool heap){
+    if(p == NULL)
+        return;
+    if(heap)
+        free(p);
+    else
+        munmap(p, mapped);
+}
+
+bufferPool::~bufferPool(){
+    for(block &b : blocks)
+        arenaFree(b.p, b.mapped, b.heap);
+}
+
+void *bufferPool::acquire(size_t bytes, size_t *mapped, bool *heap){
+    {
+        lock_guard<mutex> lock(m);
+        //smallest free block that fits, without wasting more than half of it
+        int best = -1;
+        for(int i=0; i<(int) blocks.size(); i++)
+            if(blocks[i].mapped >= bytes && blocks[i].mapped / 2 <= bytes && (best < 0 || blocks[i].mapped < blocks[best].mapped))
+                best = i;
+        if(best >= 0){
+            block b = blocks[best];
+            blocks.erase(blocks.begin() + best);
+            *mapped = b.mapped;
+            *heap = b.heap;
+            return b.p;
+        }
+    }
+
+    void *p = arenaAlloc(bytes, mapped, heap);
+    if(p == NULL){
+        std::cerr << "Error allocating " << bytes << " bytes\n";
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+void bufferPool::release(void *p, size_t mapped, bool heap){
+    lock_guard<mutex> lock(m);
+    if(blocks.size() < MAX_FREE)
+        blocks.push_back({p, mapped, heap});
+    else
+        arenaFree(p, mapped, heap);
+}
+
+bufferPool &solverPool(){
+    static bufferPool pool;
+    return pool;
+}
+
+arenaBuffer::arenaBuffer(size_t n) : n(n) {
+    p = (float *) solverPool().acquire(max(n, (size_t) 1) * sizeof(float), &mapped, &heap);
+    memset(p, 0, n * sizeof(float));
+}
+
+arenaBuffer::~arenaBuffer(){
+    solverPool().release(p, mapped, heap);
+}
+
+arenaMatrix::arenaMatrix(const vector<vector<float>> &A)
+  : n(A.size()), stride((A.size() + CACHE_LINE / sizeof(float) - 1) / (CACHE_LINE / sizeof(float)) * (CACHE_LINE / sizeof(float))),
+    buffer(A.size() * stride) {
+    for(int i=0; i<n; i++)
+        memcpy(buffer.data() + i * stride, A[i].data(), n * sizeof(float));
+}
+
+#endif // ARENA_H
@@ -0,0 +1,303 @@
+#ifndef AUTOTUNEJACOBI_H
+#define AUTOTUNEJACOBI_H
+#include<stdlib.h>
+#include<iostream>
+#include<fstream>
+#include<sstream>
+#include<vector>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "utimer.h"
+#include "utilities.h"
+#include "sequentialJacobi.h"
+#include "parallelJacobi.h"
+#include "stdparJacobi.h"
+#include "blockedKernel.h"
+#if __has_include(<ff/parallel_for.hpp>)
+#include "fflowJacobi.h"
+#define AUTOTUNE_FASTFLOW
+#endif
+
+using namespace std;
+
+/**
+ * @brief Engine, parallelism degree, row kernel and barrier chosen for a size class.
+ */
+struct tuningChoice {
+  string engine;                //seq, par, pinned, stdpar or ff
+  int n_threads;
+  long time;                    //probe time in usec
+  string kernel = "blocked";    //row kernel variant, see rowKernelVariants()
+  int tileCols = 0;             //tiles of the blocked kernel, 0 for cacheTiles()
+  int tileRows = 0;
+  string barrier = "std";       //barrier of the par engine: std or spin
+};
+
+#define PROBE_SEED 12345
+
+/**
+ * @brief Size class of a matrix: the smallest power of two not lower than matrixSize.
+ */
+int sizeClass(int matrixSize);
+
+/**
+ * @brief Default tuning cache of this host.
+ *
+ *        The JACOBI_TUNING_CACHE environment variable overrides the default
+ *        $HOME/.jacobi_tuning_<hostname>.
+ */
+string tuningCachePath();
+
+/**
+ * @brief Look up the choice for the size class of matrixSize in the tuning cache.
+ * @return false if the cache has no entry for the size class
+ */
+bool lookupTuning(const string &path, int matrixSize, tuningChoice *choice);
+
+/**
+ * @brief Run the engine of choice on the system.
+ *
+ *        The row kernel and the tiles of the choice become the engineKernel() of the
+ *        process before the engine starts.
+ */
+vector<float> runEngine(const tuningChoice &choice, int maxIter, int matrixSize, const vector<vector<float>> &A, const vector<float> &b, long *time);
+
+/**
+ * @brief Generate the random system of the probes.
+ *
+ *        Same distribution of matrixGenerator and RHSVectorGenerator, drawn from a local
+ *        generator with a fixed seed: the probes do not move the rand() sequence of the
+ *        caller and every run tunes on the same system.
+ */
+void probeSystem(int matrixSize, vector<vector<float>> &A, vector<float> &b);
+
+/**
+ * @brief Time short probes of the engines, thread counts, row kernels and barriers on a random system.
+ *
+ *        Every probe runs probeIter iterations and the fastest of two runs is kept.
+ *        The knobs are tuned in stages, each one starting from the winner of the
+ *        previous: every engine with 1, 2, 4, ... threads up to the number of hardware
+ *        threads; every row kernel of rowKernelVariants(); for the blocked kernel, the
+ *        tiles of cacheTiles() halved and doubled; for the par engine, the spin barrier.
+ *        The winner is stored in the tuning cache for the size class of matrixSize.
+ *
+ * @param matrixSize dimension of matrix (nxn)
+ * @param probeIter number of iterations of each probe
+ * @param path tuning cache
+ * @return the fastest choice
+ */
+tuningChoice autotune(int matrixSize, int probeIter, const string &path);
+
+/**
+ * @brief Jacobi algorithm with the engine chosen by the tuning cache.
+ *
+ *        If the cache has no entry for the size class, autotune() is run first.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of matrix (nxn)
+ * @param A matrix
+ * @param b vector
+ * @param time variable to store the time of the engine
+ * @param choice if not NULL, receives the engine used
+ * @return solution of Jacobi algorithm (last computation)
+ */
+vector<float> autoJacobi(int maxIter, int matrixSize, const vector<vector<float>> &A, const vector<float> &b, long *time, tuningChoice *choice);
+
+int sizeClass(int matrixSize){
+    int c = 1;
+    while(c < matrixSize)
+        c *= 2;
+    return c;
+}
+
+string tuningCachePath(){
+    const char *env = getenv("JACOBI_TUNING_CACHE");
+    if(env != NULL)
+        return env;
+
+    char host[256] = "localhost";
+    gethostname(host, sizeof(host) - 1);
+    const char *home = getenv("HOME");
+    return string(home != NULL ? home : ".") + "/.jacobi_tuning_" + host;
+}
+
+/**
+ * @brief Read all the entries of the tuning cache, one line per size class.
+ *
+ *        Line format: size class, engine, threads, probe time, kernel, tile columns,
+ *        tile rows and barrier.
+ */
+map<int, tuningChoice> readTuningCache(const string &path){
+    map<int, tuningChoice> entries;
+    ifstream in(path);
+    string line;
+    while(getline(in, line)){
+        istringstream fields(line);
+        int c;
+        tuningChoice choice;
+        if(!(fields >> c >> choice.engine >> choice.n_threads >> choice.time))
+            continue;
+        //entries written before the kernel and barrier knobs keep the defaults
+        if(!(fields >> choice.kernel >> choice.tileCols >> choice.tileRows >> choice.barrier))
+            choice = {choice.engine, choice.n_threads, choice.time};
+        entries[c] = choice;
+    }
+    return entries;
+}
+
+bool lookupTuning(const string &path, int matrixSize, tuningChoice *choice){
+    map<int, tuningChoice> entries = readTuningCache(path);
+    auto it = entries.find(sizeClass(matrixSize));
+    if(it == entries.end())
+        return false;
+    *choice = it->second;
+    return true;
+}
+
+vector<float> runEngine(const tuningChoice &choice, int maxIter, int matrixSize, const vector<vector<float>> &A, const vector<float> &b, long *time){
+    rowKernel &kernel = engineKernel();
+    kernel.variant = choice.kernel;
+    kernel.tiles = cacheTiles();
+    if(choice.tileCols > 0 && choice.tileRows > 0)
+        kernel.tiles = {choice.tileCols, choice.tileRows};
+
+    if(choice.engine == "par")
+        return parallelJacobi(maxIter, matrixSize, choice.n_threads, A, b, time, {}, nullptr, choice.barrier);
+    if(choice.engine == "pinned")
+        return parallelJacobiPinned(maxIter, matrixSize, choice.n_threads, A, b, time);
+    if(choice.engine == "stdpar")
+        return stdparJacobi(maxIter, matrixSize, choice.n_threads, A, b, time);
+#ifdef AUTOTUNE_FASTFLOW
+    if(choice.engine == "ff")
+        return fflowJacobi(maxIter, matrixSize, choice.n_threads, A, b, time);
+#endif
+    int nrIter;
+    return seqJacobi(maxIter, matrixSize, A, b, time, &nrIter);
+}
+
+void probeSystem(int matrixSize, vector<vector<float>> &A, vector<float> &b){
+    mt19937 gen(PROBE_SEED);
+    uniform_real_distribution<float> value(MIN_VALUE, MAX_VALUE);
+
+    A.assign(matrixSize, vector<float>(matrixSize, 0));
+    for(int i=0; i<matrixSize; i++){
+        float sum = 0;
+        for(int j=0; j<matrixSize; j++){
+            A[i][j] = value(gen);
+            sum += A[i][j];
+        }
+        //strongly diagonal dominant
+        A[i][i] = 2*(sum - A[i][i]);
+    }
+
+    b.resize(matrixSize);
+    for(int i=0; i<matrixSize; i++)
+        b[i] = value(gen);
+}
+
+tuningChoice autotune(int matrixSize, int probeIter, const string &path){
+    vector<vector<float>> A;
+    vector<float> b;
+    probeSystem(matrixSize, A, b);
+
+    int hw = max(1, (int) thread::hardware_concurrency());
+    vector<int> threads;
+    for(int t=1; t<hw; t*=2)
+        threads.push_back(t);
+    threads.push_back(hw);
+
+    vector<tuningChoice> candidates;
+    candidates.push_back({"seq", 1, 0});
+    vector<string> engines = {"par", "pinned", "stdpar"};
+#ifdef AUTOTUNE_FASTFLOW
+    engines.push_back("ff");
+#endif
+    for(const string &engine : engines)
+        for(int t : threads)
+            candidates.push_back({engine, t, 0});
+
+    const tileSizes &tiles = cacheTiles();
+    for(tuningChoice &candidate : candidates){
+        candidate.tileCols = tiles.cols;
+        candidate.tileRows = tiles.rows;
+    }
+
+    tuningChoice best = candidates[0];
+    best.time = -1;
+
+    //the engines print their time, keep the probes quiet
+    streambuf *out = cout.rdbuf();
+    ostringstream discard;
+    cout.rdbuf(discard.rdbuf());
+
+    auto probe = [&](tuningChoice candidate){
+        long t1, t2;
+        runEngine(candidate, probeIter, matrixSize, A, b, &t1);
+        runEngine(candidate, probeIter, matrixSize, A, b, &t2);
+        candidate.time = min(t1, t2);
+        if(best.time < 0 || candidate.time < best.time)
+            best = candidate;
+        discard.str("");
+    };
+
+    //engine and threads, with the default kernel and barrier
+    for(const tuningChoice &candidate : candidates)
+        probe(candidate);
+
+    //row kernel of the winner
+    tuningChoice base = best;
+    for(const string &variant : rowKernelVariants())
+        if(variant != base.kernel){
+            tuningChoice candidate = base;
+            candidate.kernel = variant;
+            probe(candidate);
+        }
+
+    //tiles of the blocked kernel
+    if(best.kernel == "blocked"){
+        base = best;
+        const int line = CACHE_LINE / sizeof(float);
+        for(int cols : {max(line, base.tileCols / 2 / line * line), 2 * base.tileCols})
+            probe({base.engine, base.n_threads, 0, base.kernel, cols, base.tileRows, base.barrier});
+        for(int rows : {max(1, base.tileRows / 2), 2 * base.tileRows})
+            probe({base.engine, base.n_threads, 0, base.kernel, base.tileCols, rows, base.barrier});
+    }
+
+    //barrier of the par engine
+    if(best.engine == "par"){
+        tuningChoice candidate = best;
+        candidate.barrier = "spin";
+        probe(candidate);
+    }
+
+    cout.rdbuf(out);
+
+    //update the entry of the size class, keep the others
+    map<int, tuningChoice> entries = readTuningCache(path);
+    entries[sizeClass(matrixSize)] = best;
+    ofstream cache(path, ios::trunc);
+    if(!cache)
+        std::cerr << "Error writing tuning cache " << path << "\n";
+    for(const auto &entry : entries)
+        cache << entry.first << " " << entry.second.engine << " " << entry.second.n_threads << " " << entry.second.time << " "
+              << entry.second.kernel << " " << entry.second.tileCols << " " << entry.second.tileRows << " " << entry.second.barrier << "\n";
+
+    return best;
+}
+
+vector<float> autoJacobi(int maxIter, int matrixSize, const vector<vector<float>> &A, const vector<float> &b, long *time, tuningChoice *choice){
+    string path = tuningCachePath();
+    tuningChoice selected;
+    if(!lookupTuning(path, matrixSize, &selected))
+        selected = autotune(matrixSize, min(maxIter, 20), path);
+
+    if(choice != NULL)
+        *choice = selected;
+    return runEngine(selected, maxIter, matrixSize, A, b, time);
+}
+
+#endif // AUTOTUNEJACOBI_H
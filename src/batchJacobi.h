@@ -0,0 +1,146 @@
+#ifndef BATCHJACOBI_H
+#define BATCHJACOBI_H
+#include<stdlib.h>
+#include<iostream>
+#include<vector>
+#include <atomic>
+#include <thread>
+
+#include "utimer.h"
+#include "utilities.h"
+#include "fixedJacobi.h"
+
+using namespace std;
+
+/**
+ * @brief Copy a system (M, rhs) into the packed batch buffers at position s.
+ *
+ *        The batch layout stores the systems one after the other: the matrix of the
+ *        system s starts at A[s*n*n] (row-major) and its right side at b[s*n].
+ *
+ * @param s index of the system inside the batch
+ * @param matrixSize dimension of matrix (nxn)
+ * @param M matrix of the system
+ * @param rhs right side vector of the system
+ * @param A packed matrices of the batch
+ * @param b packed right side vectors of the batch
+ */
+void packSystem(int s, int matrixSize, const vector<vector<float>> &M, const vector<float> &rhs, vector<float> &A, vector<float> &b);
+
+/**
+ * @brief Solve a single system stored in a contiguous row-major buffer.
+ *
+ *        Sizes with a compile-time specialization (see fixedJacobi.h) are dispatched to
+ *        the fixed-size kernel, the others use the generic loop.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of matrix (nxn)
+ * @param A pointer to the nxn matrix
+ * @param b pointer to the right side vector
+ * @param x pointer to the solution vector (initial guess and result)
+ * @param tmp scratch vector of length matrixSize
+ * @param tolerance threshold of the stopping criterion
+ * @return number of iterations done
+ */
+int solveSystem(int maxIter, int matrixSize, const float *A, const float *b, float *x, float *tmp, double tolerance = EPSILON);
+
+/**
+ * @brief Solve a batch of independent systems distributing whole systems across threads.
+ *
+ *        Each system is solved by one thread from beginning to end and stops as soon as
+ *        it reaches the stopping criterion, so systems converge independently. Threads
+ *        pick the next unsolved system from a shared counter, which keeps them busy when
+ *        systems need a different number of iterations. No barrier is needed.
+ *
+ *        During the execution, calculate and store the time to perform the whole batch.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of each matrix (nxn)
+ * @param n_systems number of systems in the batch
+ * @param n_threads number of threads
+ * @param A packed matrices (n_systems*matrixSize*matrixSize)
+ * @param b packed right side vectors (n_systems*matrixSize)
+ * @param time variable to store batch time
+ * @param nrIter if not NULL, receives the number of iterations done by each system
+ * @return packed solutions of the systems (n_systems*matrixSize)
+ */
+vector<float> batchJacobi(int maxIter, int matrixSize, int n_systems, int n_threads, const vector<float> &A, const vector<float> &b, long *time, vector<int> *nrIter);
+
+void packSystem(int s, int matrixSize, const vector<vector<float>> &M, const vector<float> &rhs, vector<float> &A, vector<float> &b){
+    float *As = A.data() + (size_t)s * matrixSize * matrixSize;
+    for(int i=0; i<matrixSize; i++)
+        for(int j=0; j<matrixSize; j++)
+            As[(size_t)i*matrixSize + j] = M[i][j];
+    for(int i=0; i<matrixSize; i++)
+        b[(size_t)s*matrixSize + i] = rhs[i];
+}
+
+int solveSystem(int maxIter, int matrixSize, const float *A, const float *b, float *x, float *tmp, double tolerance){
+
+    int fixedIter;
+    if(fixedJacobiDispatch(maxIter, matrixSize, A, b, x, &fixedIter, tolerance))
+        return fixedIter;
+
+    for(int iter=0; iter<maxIter; iter++){
+        float norm = 0;
+        for(int i=0; i<matrixSize; i++){
+            const float *row = A + (size_t)i*matrixSize;
+            float sum = 0;
+            for(int j=0; j<i; j++)
+                sum += row[j]*x[j];
+            for(int j=i+1; j<matrixSize; j++)
+                sum += row[j]*x[j];
+
+            tmp[i] = (b[i] - sum) / row[i];
+            norm += abs(tmp[i] - x[i]);
+        }
+
+        for(int i=0; i<matrixSize; i++)
+            x[i] = tmp[i];
+
+        //check stopping criterion on the mean difference, as the other engines do
+        if(checkStoppingCriteria(norm / (float) matrixSize, tolerance))
+            return iter;
+    }
+
+    return maxIter;
+}
+
+vector<float> batchJacobi(int maxIter, int matrixSize, int n_systems, int n_threads, const vector<float> &A, const vector<float> &b, long *time, vector<int> *nrIter){
+
+    vector<float> x((size_t)n_systems * matrixSize, 0);    //solutions, every system starts from 0
+    if(nrIter != NULL)
+        nrIter->assign(n_systems, maxIter);
+
+    atomic<int> next(0);    //index of the next system to solve
+
+    //thread lambda function: solve whole systems until the batch is empty
+    auto worker=[&](){
+        vector<float> tmp(matrixSize);
+        int s;
+        while((s = next.fetch_add(1, memory_order_relaxed)) < n_systems){
+            int it = solveSystem(maxIter, matrixSize,
+                                 A.data() + (size_t)s * matrixSize * matrixSize,
+                                 b.data() + (size_t)s * matrixSize,
+                                 x.data() + (size_t)s * matrixSize, tmp.data());
+            if(nrIter != NULL)
+                (*nrIter)[s] = it;
+        }
+    };
+
+    vector<thread> t;
+
+    {
+        utimer batchtime("Elapsed batch time = ", time);
+
+        for(int thread_i=0; thread_i<n_threads; thread_i++)
+            t.emplace_back(worker);
+
+        for(int i=0; i<n_threads; i++)
+            t[i].join();
+    }
+
+    return x;
+}
+
+#endif // BATCHJACOBI_H
@@ -0,0 +1,296 @@
+#ifndef BLOCKEDKERNEL_H
+#define BLOCKEDKERNEL_H
+#include<stdlib.h>
+#include<iostream>
+#include<fstream>
+#include<string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+
+#include "arena.h"
+
+using namespace std;
+
+/**
+ * @brief Tile sizes of the cache-blocked row kernel.
+ */
+struct tileSizes {
+  int cols;             //columns of a tile: the x segment stays in L1
+  int rows;             //rows of a block: the tile of A stays in L2
+};
+
+/**
+ * @brief Size in bytes of a data cache level, 0 if it cannot be detected.
+ *
+ * @param level cache level (1 or 2)
+ */
+long cacheSize(int level);
+
+/**
+ * @brief Tile sizes derived from the detected L1 and L2 sizes (computed once).
+ *
+ *        The x segment of a tile takes half of L1 and the tile of A half of L2, the rest
+ *        is left for the rows being prefetched. Defaults to 32 KB and 1 MB when the sizes
+ *        cannot be detected.
+ */
+const tileSizes &cacheTiles();
+
+/**
+ * @brief Off-diagonal sums of the rows [lo, hi) of a dense matrix, blocked for the caches.
+ *
+ *        The columns are split in tiles: a segment of x is applied to a whole block of rows
+ *        before moving to the next one, so it is read from L1 instead of being streamed
+ *        again for every row. The partial sums are kept in sum across the tiles. While
+ *        a group of four rows is processed together, with a register accumulator each, the
+ *        first lines of the segments of the four rows of the next group are prefetched.
+ *        Only the start of each segment is prefetched (2 KB for the group): prefetching
+ *        whole segments would take as much of L1 as the x tile and evict it, while the
+ *        hardware prefetcher follows each row once it has started. Each sum still adds the
+ *        columns in increasing order, so the result is the same of the plain loop.
+ *
+ * @param M matrix
+ * @param lo first row
+ * @param hi last row (excluded)
+ * @param x vector
+ * @param sum variable to store the sums, sum[i - lo] for the row i
+ * @param tiles tile sizes
+ */
+void blockedRowSums(const arenaMatrix &M, int lo, int hi, const float *x, float *sum, const tileSizes &tiles);
+
+/**
+ * @brief Off-diagonal sums of the rows [lo, hi) with 32 independent accumulators per row.
+ *
+ *        The compiler vectorizes the accumulators; the AVX2 and AVX-512 versions are the
+ *        same loop compiled for those instruction sets (x86-64 only). The sums are
+ *        reassociated, so the results differ in the last bits from the blocked kernel.
+ *
+ * @param M matrix
+ * @param lo first row
+ * @param hi last row (excluded)
+ * @param x vector
+ * @param sum variable to store the sums, sum[i - lo] for the row i
+ */
+void simdRowSums(const arenaMatrix &M, int lo, int hi, const float *x, float *sum);
+#if defined(__x86_64__)
+void simdRowSumsAVX2(const arenaMatrix &M, int lo, int hi, const float *x, float *sum);
+void simdRowSumsAVX512(const arenaMatrix &M, int lo, int hi, const float *x, float *sum);
+#endif
+
+/**
+ * @brief Row kernel used by the engines.
+ */
+struct rowKernel {
+  string variant;       //blocked, simd, avx2 or avx512
+  tileSizes tiles;      //tiles of the blocked kernel, also the grain of the FastFlow engine
+};
+
+/**
+ * @brief Row kernel of the engines of this process.
+ *
+ *        The default is the blocked kernel with the tiles of cacheTiles(), which gives
+ *        the same results of the plain loop; the autotuner (see autotuneJacobi.h) may
+ *        select another variant or other tiles.
+ */
+rowKernel &engineKernel();
+
+/**
+ * @brief Variants of the row kernel supported by this CPU.
+ */
+vector<string> rowKernelVariants();
+
+/**
+ * @brief Off-diagonal sums of the rows [lo, hi) with the kernel of engineKernel().
+ *
+ * @param M matrix
+ * @param lo first row
+ * @param hi last row (excluded)
+ * @param x vector
+ * @param sum variable to store the sums, sum[i - lo] for the row i
+ */
+void rowSums(const arenaMatrix &M, int lo, int hi, const float *x, float *sum);
+
+long cacheSize(int level){
+    long size = sysconf(level == 1 ? _SC_LEVEL1_DCACHE_SIZE : _SC_LEVEL2_CACHE_SIZE);
+    if(size > 0)
+        return size;
+
+    //fall back to sysfs, index0 is L1d and index2 is L2 on most systems
+    ifstream in(string("/sys/devices/system/cpu/cpu0/cache/index") + (level == 1 ? "0" : "2") + "/size");
+    long value;
+    char unit = 'K';
+    if(in >> value){
+        in >> unit;
+        return unit == 'M' ? value << 20 : value << 10;
+    }
+    return 0;
+}
+
+const tileSizes &cacheTiles(){
+    static tileSizes tiles = [](){
+        long l1 = cacheSize(1);
+        long l2 = cacheSize(2);
+        if(l1 <= 0) l1 = 32L << 10;
+        if(l2 <= 0) l2 = 1L << 20;
+
+        const int line = CACHE_LINE / sizeof(float);
+        tileSizes t;
+        t.cols = max(line, (int) (l1 / 2 / sizeof(float)) / line * line);
+        t.rows = max(1, (int) (l2 / 2 / (t.cols * sizeof(float))));
+        return t;
+    }();
+    return tiles;
+}
+
+/**
+ * @brief Add the columns [c0, c1) of R consecutive rows, starting from row i, to their sums.
+ *
+ *        The R rows share every load of x and keep R independent accumulators. The columns
+ *        i, ..., i+R-1 hold the diagonals of the rows, so they are added one by one
+ *        skipping the diagonal of each row; every sum still adds its columns in order.
+ */
+template<int R>
+void rowGroupSums(const arenaMatrix &M, int i, int c0, int c1, const float *x, float *sum){
+    const float *row[R];
+    float s[R];
+    for(int r=0; r<R; r++){
+        row[r] = M.row(i + r);
+        s[r] = sum[r];
+    }
+
+    int d0 = min(max(i, c0), c1);           //columns [d0, d1) hold diagonals of the group
+    int d1 = min(max(i + R, c0), c1);
+
+    for(int j=c0; j<d0; j++){
+        const float xj = x[j];
+        for(int r=0; r<R; r++)
+            s[r] += row[r][j]*xj;
+    }
+    for(int j=d0; j<d1; j++)
+        for(int r=0; r<R; r++)
+            if(j != i + r)
+                s[r] += row[r][j]*x[j];
+    for(int j=d1; j<c1; j++){
+        const float xj = x[j];
+        for(int r=0; r<R; r++)
+            s[r] += row[r][j]*xj;
+    }
+
+    for(int r=0; r<R; r++)
+        sum[r] = s[r];
+}
+
+void blockedRowSums(const arenaMatrix &M, int lo, int hi, const float *x, float *sum, const tileSizes &tiles){
+    const int n = M.size();
+    const int line = CACHE_LINE / sizeof(float);
+    const int GROUP = 4;
+    const int PREFETCH_LINES = 8;      //lines prefetched at the start of each row of the next group
+
+    for(int i=lo; i<hi; i++)
+        sum[i - lo] = 0;
+
+    for(int r0=lo; r0<hi; r0+=tiles.rows){
+        int r1 = min(r0 + tiles.rows, hi);
+
+        for(int c0=0; c0<n; c0+=tiles.cols){
+            int c1 = min(c0 + tiles.cols, n);
+
+            for(int i=r0; i<r1; i+=GROUP){
+                int rows = min(GROUP, r1 - i);
+
+                //start of the segments of the next group: the next rows of the tile, the first rows
+                //of the next tile at the end of the block, the first rows of the next block at the end
+                int nr, nlast, nc;
+                if(i + rows < r1){
+                    nr = i + rows; nlast = r1; nc = c0;
+                }
+                else if(c1 < n){
+                    nr = r0; nlast = r1; nc = c1;
+                }
+                else{
+                    nr = r1; nlast = min(r1 + tiles.rows, hi); nc = 0;
+                }
+                int ahead = min(PREFETCH_LINES * line, n - nc);
+                for(int r=nr; r<min(nr + GROUP, nlast); r++)
+                    for(int k=0; k<ahead; k+=line)
+                        __builtin_prefetch(M.row(r) + nc + k);
+
+                if(rows == GROUP)
+                    rowGroupSums<GROUP>(M, i, c0, c1, x, sum + (i - lo));
+                else
+                    for(int r=0; r<rows; r++)
+                        rowGroupSums<1>(M, i + r, c0, c1, x, sum + (i + r - lo));
+            }
+        }
+    }
+}
+
+#define SIMD_LANES 32
+#define SIMD_DOT(lo, hi)                                            \
+    {                                                               \
+        float acc[SIMD_LANES] = {0};                                \
+        int j = lo;                                                 \
+        for(; j + SIMD_LANES <= hi; j += SIMD_LANES)                \
+            for(int l=0; l<SIMD_LANES; l++)                         \
+                acc[l] += row[j + l]*x[j + l];                      \
+        for(; j < hi; j++)                                          \
+            s += row[j]*x[j];                                       \
+        for(int l=0; l<SIMD_LANES; l++)                             \
+            s += acc[l];                                            \
+    }
+#define SIMD_ROW_SUMS                                               \
+    const int n = M.size();                                         \
+    for(int i=lo; i<hi; i++){                                       \
+        const float *row = M.row(i);                                \
+        float s = 0;                                                \
+        SIMD_DOT(0, i)                                              \
+        SIMD_DOT(i + 1, n)                                          \
+        sum[i - lo] = s;                                            \
+    }
+
+void simdRowSums(const arenaMatrix &M, int lo, int hi, const float *x, float *sum){
+    SIMD_ROW_SUMS
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2,fma")))
+void simdRowSumsAVX2(const arenaMatrix &M, int lo, int hi, const float *x, float *sum){
+    SIMD_ROW_SUMS
+}
+
+__attribute__((target("avx512f,prefer-vector-width=512")))
+void simdRowSumsAVX512(const arenaMatrix &M, int lo, int hi, const float *x, float *sum){
+    SIMD_ROW_SUMS
+}
+#endif
+
+rowKernel &engineKernel(){
+    static rowKernel kernel = {"blocked", cacheTiles()};
+    return kernel;
+}
+
+vector<string> rowKernelVariants(){
+    vector<string> variants = {"blocked", "simd"};
+#if defined(__x86_64__)
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        variants.push_back("avx2");
+    if(__builtin_cpu_supports("avx512f"))
+        variants.push_back("avx512");
+#endif
+    return variants;
+}
+
+void rowSums(const arenaMatrix &M, int lo, int hi, const float *x, float *sum){
+    const rowKernel &kernel = engineKernel();
+#if defined(__x86_64__)
+    if(kernel.variant == "avx512")
+        return simdRowSumsAVX512(M, lo, hi, x, sum);
+    if(kernel.variant == "avx2")
+        return simdRowSumsAVX2(M, lo, hi, x, sum);
+#endif
+    if(kernel.variant == "simd")
+        return simdRowSums(M, lo, hi, x, sum);
+    blockedRowSums(M, lo, hi, x, sum, kernel.tiles);
+}
+
+#endif // BLOCKEDKERNEL_H
@@ -0,0 +1,247 @@
+#ifndef CHECKPOINTJACOBI_H
+#define CHECKPOINTJACOBI_H
+#include<stdlib.h>
+#include<iostream>
+#include<fstream>
+#include<vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "utimer.h"
+#include "utilities.h"
+#include "parallelJacobi.h"
+
+using namespace std;
+
+//checkpoint file: magic, version, n, iteration, number of norms, iterate, norm history
+const uint32_t CHECKPOINT_MAGIC = 0x504b434a;   //"JCKP"
+const uint32_t CHECKPOINT_VERSION = 1;
+
+/**
+ * @brief Background writer of Jacobi checkpoints.
+ *
+ *        snapshot() only copies the iterate and the norms of the last iterations in a
+ *        buffer and wakes up the writer thread, which keeps the whole norm history and
+ *        writes the last snapshot on disk while the computation goes on. If a new snapshot
+ *        arrives before the previous one is written, the older iterate is dropped and the
+ *        norms are appended.
+ *        The file is written to a temporary path and renamed, so a preemption during
+ *        the write never leaves a truncated checkpoint.
+ */
+class checkpointWriter {
+  string path;
+  mutex m;
+  condition_variable cv;
+  bool pending;
+  bool stop;
+
+  //snapshot buffer, filled by snapshot() and consumed by the writer thread
+  int iter;
+  vector<float> x;
+  vector<float> norms;          //norms not yet taken by the writer thread
+  vector<float> history;        //norm history, owned by the writer thread
+
+  thread writer;
+
+  void run();
+
+public:
+
+  /**
+   * @param path checkpoint file
+   * @param normHistory norms of the iterations done before (on restart)
+   */
+  checkpointWriter(const string &path, const vector<float> &normHistory = {});
+
+  /**
+   * @brief Write the pending snapshot (if any) and stop the writer thread.
+   */
+  ~checkpointWriter();
+
+  /**
+   * @brief Queue the state of the computation for writing.
+   * @param iteration number of iterations done
+   * @param value current iterate
+   * @param n dimension of the iterate
+   * @param newNorms norms of the iterations done since the previous snapshot
+   */
+  void snapshot(int iteration, const float *value, int n, const vector<float> &newNorms);
+};
+
+/**
+ * @brief Write a checkpoint file.
+ * @return false if the file cannot be written
+ */
+bool writeCheckpoint(const string &path, int iter, const vector<float> &x, const vector<float> &norms);
+
+/**
+ * @brief Read a checkpoint file.
+ *
+ * @param path checkpoint file
+ * @param matrixSize expected dimension of the iterate
+ * @param iter variable to store the number of iterations done
+ * @param x variable to store the iterate
+ * @param norms variable to store the norm history
+ * @return false if the file is missing, corrupted or for a different matrix size
+ */
+bool loadCheckpoint(const string &path, int matrixSize, int *iter, vector<float> &x, vector<float> &norms);
+
+/**
+ * @brief Parallel version of Jacobi algorithm with barriers and periodic checkpoints.
+ *
+ *        Runs parallelJacobi with an iteration hook: every checkpointEvery iterations the
+ *        barrier callback hands the iterate, the iteration count and the norms since the
+ *        previous checkpoint to a checkpointWriter, so workers never wait for the disk. With restart set, the
+ *        computation resumes from the checkpoint (if a valid one exists) and maxIter
+ *        counts the iterations done before the restart too. A restart from the final
+ *        checkpoint of a converged computation returns the checkpoint without iterating.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of matrix (nxn)
+ * @param n_threads number of threads
+ * @param A matrix
+ * @param b vector
+ * @param time variable to store parallel time
+ * @param path checkpoint file
+ * @param checkpointEvery number of iterations between two checkpoints
+ * @param restart resume from the checkpoint in path
+ * @param nrIter variable to store the index of the converged iteration (counting the ones before the restart), unchanged if it does not converge
+ * @return solution of Jacobi algorithm (last computation)
+ */
+vector<float> checkpointJacobi(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time, const string &path, int checkpointEvery, bool restart, int *nrIter);
+
+bool writeCheckpoint(const string &path, int iter, const vector<float> &x, const vector<float> &norms){
+    string tmpPath = path + ".tmp";
+    {
+        ofstream out(tmpPath, ios::binary | ios::trunc);
+        if(!out)
+            return false;
+
+        uint32_t header[5] = {CHECKPOINT_MAGIC, CHECKPOINT_VERSION, (uint32_t) x.size(), (uint32_t) iter, (uint32_t) norms.size()};
+        out.write((const char *) header, sizeof(header));
+        out.write((const char *) x.data(), x.size() * sizeof(float));
+        out.write((const char *) norms.data(), norms.size() * sizeof(float));
+        if(!out)
+            return false;
+    }
+    return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool loadCheckpoint(const string &path, int matrixSize, int *iter, vector<float> &x, vector<float> &norms){
+    ifstream in(path, ios::binary);
+    if(!in)
+        return false;
+
+    uint32_t header[5];
+    if(!in.read((char *) header, sizeof(header)))
+        return false;
+    if(header[0] != CHECKPOINT_MAGIC || header[1] != CHECKPOINT_VERSION || header[2] != (uint32_t) matrixSize)
+        return false;
+
+    vector<float> value(header[2]);
+    vector<float> history(header[4]);
+    in.read((char *) value.data(), value.size() * sizeof(float));
+    in.read((char *) history.data(), history.size() * sizeof(float));
+    if(!in)
+        return false;
+
+    *iter = header[3];
+    x.swap(value);
+    norms.swap(history);
+    return true;
+}
+
+checkpointWriter::checkpointWriter(const string &path, const vector<float> &normHistory) : path(path), pending(false), stop(false), iter(0), history(normHistory) {
+    writer = thread(&checkpointWriter::run, this);
+}
+
+checkpointWriter::~checkpointWriter(){
+    {
+        lock_guard<mutex> lock(m);
+        stop = true;
+    }
+    cv.notify_one();
+    writer.join();
+}
+
+void checkpointWriter::snapshot(int iteration, const float *value, int n, const vector<float> &newNorms){
+    {
+        lock_guard<mutex> lock(m);
+        iter = iteration;
+        x.assign(value, value + n);
+        norms.insert(norms.end(), newNorms.begin(), newNorms.end());
+        pending = true;
+    }
+    cv.notify_one();
+}
+
+void checkpointWriter::run(){
+    int wIter;
+    vector<float> wx;
+
+    unique_lock<mutex> lock(m);
+    while(true){
+        cv.wait(lock, [&](){ return pending || stop; });
+        if(!pending)
+            return;
+
+        //take the snapshot and write it without holding the lock
+        wIter = iter;
+        wx.swap(x);
+        history.insert(history.end(), norms.begin(), norms.end());
+        norms.clear();
+        pending = false;
+        lock.unlock();
+
+        if(!writeCheckpoint(path, wIter, wx, history))
+            std::cerr << "Error writing checkpoint " << path << "\n";
+
+        lock.lock();
+    }
+}
+
+vector<float> checkpointJacobi(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time, const string &path, int checkpointEvery, bool restart, int *nrIter){
+
+    vector<float> x0;               //initial guess, the checkpoint on restart
+    vector<float> normHistory;      //norms of the iterations before the restart
+
+    int iter = 0;   //iterations done
+    if(restart){
+        if(loadCheckpoint(path, matrixSize, &iter, x0, normHistory))
+            std::cout << "Restart from iteration " << iter << std::endl;
+        else
+            std::cerr << "No valid checkpoint in " << path << ", starting from zero\n";
+    }
+
+    //the checkpoint is the result of a converged computation
+    if(!normHistory.empty() && checkStoppingCriteria(normHistory.back())){
+        *time = 0;
+        *nrIter = iter - 1;
+        return x0;
+    }
+
+    checkpointWriter checkpoint(path, normHistory);
+    vector<float> newNorms;         //norms since the last checkpoint
+
+    vector<float> res = parallelJacobi(maxIter - iter, matrixSize, n_threads, A, b, time, x0, [&](float norm, const float *x){
+        newNorms.push_back(norm);
+        if(checkStoppingCriteria(norm))
+            *nrIter = iter;
+        iter++;
+        if(iter % checkpointEvery == 0){
+            checkpoint.snapshot(iter, x, matrixSize, newNorms);
+            newNorms.clear();
+        }
+    });
+
+    //final checkpoint, with the norm of the converged iteration last in the history
+    checkpoint.snapshot(iter, res.data(), matrixSize, newNorms);
+
+    return res;
+}
+
+#endif // CHECKPOINTJACOBI_H
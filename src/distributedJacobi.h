@@ -0,0 +1,417 @@
+#ifndef DISTRIBUTEDJACOBI_H
+#define DISTRIBUTEDJACOBI_H
+#include<stdlib.h>
+#include<iostream>
+#include<vector>
+#include <atomic>
+#include <new>
+#include <climits>
+#include <string>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/futex.h>
+
+#include "utimer.h"
+#include "utilities.h"
+
+using namespace std;
+
+/**
+ * @brief Communication layer between the ranks of distributedJacobi.
+ *
+ *        A transport is built by the launcher before the ranks are forked, then every rank
+ *        calls attach() with its own rank and exchange() once per iteration.
+ */
+class jacobiTransport {
+public:
+  virtual ~jacobiTransport() {}
+
+  /**
+   * @brief Called by a rank after the fork, before the first exchange.
+   * @param rank index of the rank
+   */
+  virtual void attach(int rank) {}
+
+  /**
+   * @brief Gather the slices of the iterate of all the ranks and sum their partial norms.
+   *
+   * @param rank index of the rank
+   * @param lo first row owned by the rank
+   * @param hi last row (excluded) owned by the rank
+   * @param slice new value of the rows [lo, hi)
+   * @param partialNorm norm of the rows [lo, hi)
+   * @param x full iterate, filled with the slices of every rank
+   * @return sum of the partial norms of every rank
+   */
+  virtual float exchange(int rank, int lo, int hi, const float *slice, float partialNorm, float *x) = 0;
+};
+
+/**
+ * @brief Rows [lo, hi) of the block owned by rank, same chunking of parallelJacobi.
+ */
+void rankRows(int matrixSize, int n_ranks, int rank, int *lo, int *hi){
+    int n_chunk = matrixSize % n_ranks == 0 ? (matrixSize / n_ranks) : (matrixSize / n_ranks) + 1;
+    *lo = min(rank * n_chunk, matrixSize);
+    *hi = min(*lo + n_chunk, matrixSize);
+}
+
+/**
+ * @brief Transport on a POSIX shared-memory segment with a futex barrier.
+ *
+ *        Each rank writes its slice and partial norm in the shared iterate, waits on the
+ *        barrier and copies the whole iterate back. Two buffers are used alternately, so
+ *        the writes of the next iteration never overlap the reads of the current one.
+ */
+class shmTransport : public jacobiTransport {
+  struct header {
+    atomic<int> count;          //ranks arrived at the barrier
+    atomic<int> generation;     //futex word, incremented when the barrier opens
+  };
+
+  int n_ranks;
+  int matrixSize;
+  size_t bytes;
+  void *segment;
+  header *h;
+  float *buffer[2];             //shared iterates
+  float *norms[2];              //shared partial norms
+  int parity;
+
+  void barrier(){
+    int gen = h->generation.load(memory_order_acquire);
+    if(h->count.fetch_add(1, memory_order_acq_rel) + 1 == n_ranks){
+        h->count.store(0, memory_order_relaxed);
+        h->generation.fetch_add(1, memory_order_release);
+        syscall(SYS_futex, (int *) &h->generation, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+    else{
+        while(h->generation.load(memory_order_acquire) == gen)
+            syscall(SYS_futex, (int *) &h->generation, FUTEX_WAIT, gen, NULL, NULL, 0);
+    }
+  }
+
+public:
+
+  shmTransport(int n_ranks, int matrixSize) : n_ranks(n_ranks), matrixSize(matrixSize), parity(0) {
+    bytes = sizeof(header) + 2 * (matrixSize + n_ranks) * sizeof(float);
+
+    //the name is removed at once, the ranks inherit the mapping through the fork
+    string name = "/jacobi_" + to_string(getpid());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0 || ftruncate(fd, bytes) != 0){
+        std::cerr << "Error creating shared memory " << name << "\n";
+        exit(EXIT_FAILURE);
+    }
+    segment = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    shm_unlink(name.c_str());
+    if(segment == MAP_FAILED){
+        std::cerr << "Error mapping shared memory " << name << "\n";
+        exit(EXIT_FAILURE);
+    }
+
+    h = new (segment) header;
+    h->count.store(0);
+    h->generation.store(0);
+    buffer[0] = (float *) (h + 1);
+    buffer[1] = buffer[0] + matrixSize;
+    norms[0] = buffer[1] + matrixSize;
+    norms[1] = norms[0] + n_ranks;
+  }
+
+  ~shmTransport(){
+    munmap(segment, bytes);
+  }
+
+  float exchange(int rank, int lo, int hi, const float *slice, float partialNorm, float *x){
+    float *shared = buffer[parity];
+    for(int i=lo; i<hi; i++)
+        shared[i] = slice[i - lo];
+    norms[parity][rank] = partialNorm;
+
+    barrier();
+
+    for(int i=0; i<matrixSize; i++)
+        x[i] = shared[i];
+    float total = 0;
+    for(int r=0; r<n_ranks; r++)
+        total += norms[parity][r];
+
+    parity ^= 1;
+    return total;
+  }
+};
+
+/**
+ * @brief Transport on Unix domain sockets with rank 0 as root.
+ *
+ *        Every rank sends its slice and partial norm to rank 0, which assembles the
+ *        iterate and sends it back with the total norm. The same messages can travel
+ *        on TCP sockets between nodes.
+ */
+class socketTransport : public jacobiTransport {
+  int n_ranks;
+  int matrixSize;
+  vector<int> rootFd;           //rootFd[r]: rank 0 side of the socket with rank r
+  vector<int> rankFd;           //rankFd[r]: rank r side of the socket with rank 0
+  vector<float> message;
+
+  static void sendAll(int fd, const void *data, size_t len){
+    const char *p = (const char *) data;
+    while(len > 0){
+        ssize_t n = write(fd, p, len);
+        if(n <= 0){
+            std::cerr << "Error writing on socket\n";
+            _exit(EXIT_FAILURE);
+        }
+        p += n;
+        len -= n;
+    }
+  }
+
+  static void recvAll(int fd, void *data, size_t len){
+    char *p = (char *) data;
+    while(len > 0){
+        ssize_t n = read(fd, p, len);
+        if(n <= 0){
+            std::cerr << "Error reading from socket\n";
+            _exit(EXIT_FAILURE);
+        }
+        p += n;
+        len -= n;
+    }
+  }
+
+public:
+
+  socketTransport(int n_ranks, int matrixSize) : n_ranks(n_ranks), matrixSize(matrixSize), rootFd(n_ranks, -1), rankFd(n_ranks, -1), message(matrixSize + 1) {
+    for(int r=1; r<n_ranks; r++){
+        int sv[2];
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0){
+            std::cerr << "Error creating socket pair\n";
+            exit(EXIT_FAILURE);
+        }
+        rootFd[r] = sv[0];
+        rankFd[r] = sv[1];
+    }
+  }
+
+  ~socketTransport(){
+    for(int r=1; r<n_ranks; r++){
+        if(rootFd[r] >= 0) close(rootFd[r]);
+        if(rankFd[r] >= 0) close(rankFd[r]);
+    }
+  }
+
+  void attach(int rank){
+    //keep only the sockets used by this rank
+    for(int r=1; r<n_ranks; r++){
+        if(rank != 0){
+            close(rootFd[r]);
+            rootFd[r] = -1;
+        }
+        if(r != rank){
+            close(rankFd[r]);
+            rankFd[r] = -1;
+        }
+    }
+  }
+
+  float exchange(int rank, int lo, int hi, const float *slice, float partialNorm, float *x){
+    if(rank != 0){
+        message[0] = partialNorm;
+        for(int i=lo; i<hi; i++)
+            message[1 + i - lo] = slice[i - lo];
+        sendAll(rankFd[rank], message.data(), (1 + hi - lo) * sizeof(float));
+
+        recvAll(rankFd[rank], message.data(), (1 + matrixSize) * sizeof(float));
+        for(int i=0; i<matrixSize; i++)
+            x[i] = message[1 + i];
+        return message[0];
+    }
+
+    float total = partialNorm;
+    for(int i=lo; i<hi; i++)
+        x[i] = slice[i - lo];
+    for(int r=1; r<n_ranks; r++){
+        int rlo, rhi;
+        rankRows(matrixSize, n_ranks, r, &rlo, &rhi);
+        recvAll(rootFd[r], message.data(), (1 + rhi - rlo) * sizeof(float));
+        total += message[0];
+        for(int i=rlo; i<rhi; i++)
+            x[i] = message[1 + i - rlo];
+    }
+
+    message[0] = total;
+    for(int i=0; i<matrixSize; i++)
+        message[1 + i] = x[i];
+    for(int r=1; r<n_ranks; r++)
+        sendAll(rootFd[r], message.data(), (1 + matrixSize) * sizeof(float));
+    return total;
+  }
+};
+
+/**
+ * @brief Distributed-memory version of Jacobi algorithm with one process per rank.
+ *
+ *        The launcher forks n_ranks processes. Each rank copies its own row block of A and
+ *        of b, computes the new value of its rows and exchanges only that slice of the
+ *        iterate through the transport, together with its partial norm. All the ranks get
+ *        the same total norm, so they stop at the same iteration.
+ *
+ *        If a rank fails, the launcher kills the other ranks, which would otherwise wait
+ *        for it forever, sets nrIter to -1 and returns an empty vector. The ranks are also
+ *        killed if the launcher dies. Only the forked ranks are waited for, so other
+ *        children of the calling process are left alone.
+ *
+ *        During the execution, calculate and store the time to perform the algorithm.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of matrix (nxn)
+ * @param n_ranks number of processes
+ * @param A matrix
+ * @param b vector
+ * @param time variable to store distributed time
+ * @param transport "shm" for shared memory, "socket" for Unix domain sockets
+ * @param nrIter number of iterations done
+ * @return solution of Jacobi algorithm (last computation), empty if a rank failed
+ */
+vector<float> distributedJacobi(int maxIter, int matrixSize, int n_ranks, vector<vector<float>> A, vector<float> b, long *time, const string &transport, int *nrIter);
+
+/**
+ * @brief Body of a rank of distributedJacobi.
+ * @return number of iterations done
+ */
+int jacobiRank(int maxIter, int matrixSize, int n_ranks, int rank, const vector<vector<float>> &A, const vector<float> &b, jacobiTransport *net, float *x){
+    int lo, hi;
+    rankRows(matrixSize, n_ranks, rank, &lo, &hi);
+
+    //local copy of the row block, the only part of A this rank touches
+    vector<float> localA((size_t)(hi - lo) * matrixSize);
+    vector<float> localB(b.begin() + lo, b.begin() + hi);
+    for(int i=lo; i<hi; i++)
+        for(int j=0; j<matrixSize; j++)
+            localA[(size_t)(i - lo) * matrixSize + j] = A[i][j];
+
+    vector<float> old_value(matrixSize, 0);     //previous value of the computation
+    vector<float> slice(hi - lo, 0);            //new value of the rows of the rank
+
+    for(int iter=0; iter<maxIter; iter++){
+        float norm = 0;
+        for(int i=lo; i<hi; i++){
+            const float *row = localA.data() + (size_t)(i - lo) * matrixSize;
+            float sum = 0;
+            for(int j=0; j<i; j++)
+                sum += row[j]*old_value[j];
+            for(int j=i+1; j<matrixSize; j++)
+                sum += row[j]*old_value[j];
+
+            slice[i - lo] = (localB[i - lo] - sum) / row[i];
+            norm += abs(old_value[i] - slice[i - lo]);
+        }
+
+        float total = net->exchange(rank, lo, hi, slice.data(), norm, old_value.data());
+
+        if(checkStoppingCriteria(total / (float) matrixSize)){
+            if(x != NULL)
+                copy(old_value.begin(), old_value.end(), x);
+            return iter;
+        }
+    }
+
+    if(x != NULL)
+        copy(old_value.begin(), old_value.end(), x);
+    return maxIter;
+}
+
+vector<float> distributedJacobi(int maxIter, int matrixSize, int n_ranks, vector<vector<float>> A, vector<float> b, long *time, const string &transport, int *nrIter){
+
+    jacobiTransport *net;
+    if(transport == "socket")
+        net = new socketTransport(n_ranks, matrixSize);
+    else
+        net = new shmTransport(n_ranks, matrixSize);
+
+    //rank 0 leaves the solution and the number of iterations here
+    size_t resultBytes = sizeof(int) + matrixSize * sizeof(float);
+    void *result = mmap(NULL, resultBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(result == MAP_FAILED){
+        std::cerr << "Error mapping result buffer\n";
+        exit(EXIT_FAILURE);
+    }
+    int *resIter = (int *) result;
+    float *resX = (float *) (resIter + 1);
+    *resIter = -1;
+
+    vector<pid_t> pid(n_ranks);
+    bool failed = false;
+    std::cout.flush();
+
+    {
+        utimer distributedtime("Elapsed distributed time = ", time);
+
+        for(int rank=0; rank<n_ranks; rank++){
+            pid[rank] = fork();
+            if(pid[rank] < 0){
+                std::cerr << "Error forking rank " << rank << "\n";
+                exit(EXIT_FAILURE);
+            }
+            if(pid[rank] == 0){
+                //do not outlive the launcher
+                prctl(PR_SET_PDEATHSIG, SIGKILL);
+                if(getppid() == 1)
+                    _exit(EXIT_FAILURE);
+                net->attach(rank);
+                int it = jacobiRank(maxIter, matrixSize, n_ranks, rank, A, b, net, rank == 0 ? resX : NULL);
+                if(rank == 0)
+                    *resIter = it;
+                _exit(EXIT_SUCCESS);
+            }
+        }
+
+        //poll the ranks until all of them end, on the first failure kill the ones still waiting for it
+        for(int left=n_ranks; left>0; ){
+            bool reaped = false;
+            for(int rank=0; rank<n_ranks; rank++){
+                if(pid[rank] <= 0)
+                    continue;
+                int status;
+                pid_t done = waitpid(pid[rank], &status, WNOHANG);
+                if(done == 0)
+                    continue;
+                pid[rank] = 0;
+                left--;
+                reaped = true;
+
+                if(!failed && (done < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)){
+                    std::cerr << "Rank " << rank << " failed, stopping the other ranks\n";
+                    failed = true;
+                    for(int r=0; r<n_ranks; r++)
+                        if(pid[r] > 0)
+                            kill(pid[r], SIGKILL);
+                }
+            }
+            if(!reaped)
+                usleep(100);
+        }
+        if(failed)
+            *resIter = -1;
+    }
+
+    vector<float> new_value;
+    if(!failed)
+        new_value.assign(resX, resX + matrixSize);
+    *nrIter = *resIter;
+
+    munmap(result, resultBytes);
+    delete net;
+    return new_value;
+}
+
+#endif // DISTRIBUTEDJACOBI_H
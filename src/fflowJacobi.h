@@ -8,6 +8,8 @@
 
 #include "utimer.h"
 #include "utilities.h"
+#include "arena.h"
+#include "blockedKernel.h"
 
 using namespace std;
 
@@ -17,6 +19,10 @@ using namespace std;
  *        Get a square matrix and vector and compute the Jacobi method for determining
  *        the solution of a strictly diagonally dominant system of linear equation.
  *
+ *        The matrix is copied in a contiguous pooled buffer (see arena.h). Each task of
+ *        the parallel_for is a block of rows (the rows of a tile of engineKernel()) whose
+ *        sums are computed by its row kernel (see blockedKernel.h).
+ *
  *        During the execution, calculate and store the time to perform the algorithm.
  *
  * @param maxIter maximum number of iterations
@@ -27,12 +33,15 @@ using namespace std;
  * @param time variable to store fastflow time
  * @return solution of Jacobi algorithm (last computation)
  */
-vector<float> fflowJacobi(int maxIter, int matrixSize, int n_threads, vector<vector<float>> A, vector<float> b, long *time);
+vector<float> fflowJacobi(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time);
 
-vector<float> fflowJacobi(int maxIter, int matrixSize, int n_threads, vector<vector<float>> A, vector<float> b, long *time){
+vector<float> fflowJacobi(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time){
 
-    vector<float> old_value(matrixSize, 0);        //previous value of the computation
+    arenaMatrix M(A);                              //contiguous copy of the matrix
+    arenaBuffer old_value(matrixSize);             //previous value of the computation
     vector<float> new_value(matrixSize, 0);        //new value of the computation
+    arenaBuffer rowSum(matrixSize);                //off-diagonal sums of the rows
+    const tileSizes &tiles = engineKernel().tiles;   //a block of rows per task
 
     //using a ParalleFor object with n_threads workers applying nonblocking policy
     ff::ParallelFor parallelCycle(n_threads, true);
@@ -42,21 +51,20 @@ vector<float> fflowJacobi(int maxIter, int matrixSize, int n_threads, vector<vec
 
         for(int k=0; k<maxIter; k++){
             //apply parallelFor object
-            parallelCycle.parallel_for(0, matrixSize, 1, 0, [&](const long i){
-                float sum=0;
-                for(int j=0; j<i; j++)
-                    sum+=A[i][j]*old_value[j];
-                for(int j=i+1; j<b.size(); j++)
-                    sum+=A[i][j]*old_value[j];
-
-                new_value[i]=(b[i]-sum)/A[i][i];
+            parallelCycle.parallel_for_idx(0, matrixSize, 1, tiles.rows, [&](const long start, const long stop, const int thid){
+                rowSums(M, start, stop, old_value.data(), rowSum.data() + start);
+                for(long i=start; i<stop; i++)
+                    new_value[i]=(b[i]-rowSum[i])/M.row(i)[i];
             }, n_threads);
 
             //check stopping criterion to stop the algorithm and save the number of iterations done
-            if(checkStoppingCriteria(old_value, new_value))
+            float norm = 0;
+            for(int i=0; i<matrixSize; i++)
+                norm += abs(old_value[i] - new_value[i]);
+            if(checkStoppingCriteria(norm / (float) matrixSize))
                 break;
             else
-                old_value = new_value;
+                copy(new_value.begin(), new_value.end(), old_value.data());
         }
     }
 
@@ -0,0 +1,115 @@
+#ifndef FIXEDJACOBI_H
+#define FIXEDJACOBI_H
+#include<stdlib.h>
+#include<iostream>
+#include<array>
+
+#include "utilities.h"
+
+using namespace std;
+
+/**
+ * @brief Jacobi algorithm specialized at compile time for a fixed matrix size N.
+ *
+ *        The matrix is stored transposed and without diagonal, so every iteration updates
+ *        all the N partial sums at once with loops of known trip count that the compiler
+ *        vectorizes without bounds checks or diagonal branches. Each sum still accumulates the columns in the
+ *        same order as seqJacobi, so the result is the same.
+ *
+ * @param maxIter maximum number of iterations
+ * @param A matrix (row-major, NxN)
+ * @param b vector
+ * @param x initial guess, overwritten with the solution
+ * @param tolerance threshold of the stopping criterion
+ * @return number of iterations done
+ */
+template<int N>
+int fixedJacobi(int maxIter, const array<float, N*N> &A, const array<float, N> &b, array<float, N> &x, double tolerance = EPSILON);
+
+/**
+ * @brief Solve a system with the fixed-size kernel if one exists for matrixSize.
+ *
+ *        Specializations are available for 4, 8, 16, 32 and 64.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of matrix (nxn)
+ * @param A pointer to the nxn matrix (row-major)
+ * @param b pointer to the right side vector
+ * @param x pointer to the initial guess, overwritten with the solution
+ * @param nrIter variable to store the number of iterations done
+ * @param tolerance threshold of the stopping criterion
+ * @return false if there is no specialization for matrixSize (x untouched)
+ */
+bool fixedJacobiDispatch(int maxIter, int matrixSize, const float *A, const float *b, float *x, int *nrIter, double tolerance = EPSILON);
+
+template<int N>
+int fixedJacobi(int maxIter, const array<float, N*N> &A, const array<float, N> &b, array<float, N> &x, double tolerance){
+
+    array<float, N*N> T;    //transposed matrix with zero diagonal
+    array<float, N> d;      //diagonal of the matrix
+
+    for(int i=0; i<N; i++)
+        for(int j=0; j<N; j++)
+            T[j*N + i] = A[i*N + j];
+    for(int i=0; i<N; i++){
+        d[i] = A[i*N + i];
+        T[i*N + i] = 0;
+    }
+
+    for(int iter=0; iter<maxIter; iter++){
+        array<float, N> sum{};
+        for(int j=0; j<N; j++){
+            const float xj = x[j];
+            //keep the loop for the vectorizer, complete unrolling first would hide it
+#pragma GCC unroll 1
+            for(int i=0; i<N; i++)
+                sum[i] += T[j*N + i]*xj;
+        }
+
+        float norm = 0;
+        for(int i=0; i<N; i++){
+            float value = (b[i] - sum[i]) / d[i];
+            norm += abs(value - x[i]);
+            x[i] = value;
+        }
+
+        if(checkStoppingCriteria(norm / (float) N, tolerance))
+            return iter;
+    }
+
+    return maxIter;
+}
+
+/**
+ * @brief Copy the system in std::array storage and run fixedJacobi<N>.
+ */
+template<int N>
+int fixedJacobiFromBuffer(int maxIter, const float *A, const float *b, float *x, double tolerance){
+    array<float, N*N> As;
+    array<float, N> bs, xs;
+    for(int i=0; i<N*N; i++)
+        As[i] = A[i];
+    for(int i=0; i<N; i++){
+        bs[i] = b[i];
+        xs[i] = x[i];
+    }
+
+    int iter = fixedJacobi<N>(maxIter, As, bs, xs, tolerance);
+
+    for(int i=0; i<N; i++)
+        x[i] = xs[i];
+    return iter;
+}
+
+bool fixedJacobiDispatch(int maxIter, int matrixSize, const float *A, const float *b, float *x, int *nrIter, double tolerance){
+    switch(matrixSize){
+        case 4:  *nrIter = fixedJacobiFromBuffer<4>(maxIter, A, b, x, tolerance);  return true;
+        case 8:  *nrIter = fixedJacobiFromBuffer<8>(maxIter, A, b, x, tolerance);  return true;
+        case 16: *nrIter = fixedJacobiFromBuffer<16>(maxIter, A, b, x, tolerance); return true;
+        case 32: *nrIter = fixedJacobiFromBuffer<32>(maxIter, A, b, x, tolerance); return true;
+        case 64: *nrIter = fixedJacobiFromBuffer<64>(maxIter, A, b, x, tolerance); return true;
+        default: return false;
+    }
+}
+
+#endif // FIXEDJACOBI_H
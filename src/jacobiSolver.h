@@ -0,0 +1,148 @@
+#ifndef JACOBISOLVER_H
+#define JACOBISOLVER_H
+#include<stdlib.h>
+#include<iostream>
+#include<vector>
+
+#include "utimer.h"
+#include "utilities.h"
+
+using namespace std;
+
+/**
+ * @brief Stateful Jacobi solver for systems that change slowly between solves.
+ *
+ *        The solver keeps the system and the last iterate. Every call to solve() resumes
+ *        from the last iterate (or from the guess given with setInitialGuess), so after a
+ *        small update of b or of a few rows of A the previous solution is used as the
+ *        starting point instead of the zero vector.
+ */
+class jacobiSolver {
+  int matrixSize;
+  vector<vector<float>> A;
+  vector<float> b;
+  vector<float> diag;       //diagonal of A, updated together with the rows
+  vector<float> x;          //current iterate
+  vector<float> tmp;        //new value of the computation
+
+public:
+
+  /**
+   * @brief Build the solver, the first solve starts from the zero vector.
+   * @param A matrix
+   * @param b vector
+   */
+  jacobiSolver(const vector<vector<float>> &A, const vector<float> &b);
+
+  /**
+   * @brief Set the initial guess used by the next solve.
+   * @param x0 initial guess (length n)
+   * @return false if x0 has not length n, the solver is unchanged
+   */
+  bool setInitialGuess(const vector<float> &x0);
+
+  /**
+   * @brief Replace the whole right side vector.
+   * @param newB vector (length n)
+   * @return false if newB has not length n, the solver is unchanged
+   */
+  bool updateRHS(const vector<float> &newB);
+
+  /**
+   * @brief Replace a single entry of the right side vector.
+   * @param i index of the entry
+   * @param value new value
+   * @return false if i is out of range, the solver is unchanged
+   */
+  bool updateRHS(int i, float value);
+
+  /**
+   * @brief Replace the row i of A, only the diagonal entry of that row is recomputed.
+   * @param i index of the row
+   * @param row new row (length n)
+   * @return false if i is out of range or row has not length n, the solver is unchanged
+   */
+  bool updateRow(int i, const vector<float> &row);
+
+  /**
+   * @brief Iterate from the current iterate until the stopping criterion or maxIter.
+   *
+   * @param maxIter maximum number of iterations
+   * @param time variable to store the solve time
+   * @return number of iterations done
+   */
+  int solve(int maxIter, long *time);
+
+  /**
+   * @brief Current iterate, the solution after a converged solve.
+   */
+  const vector<float> &solution() const { return x; }
+};
+
+jacobiSolver::jacobiSolver(const vector<vector<float>> &A, const vector<float> &b)
+  : matrixSize(b.size()), A(A), b(b), diag(b.size()), x(b.size(), 0), tmp(b.size(), 0) {
+    for(int i=0; i<matrixSize; i++)
+        diag[i] = A[i][i];
+}
+
+bool jacobiSolver::setInitialGuess(const vector<float> &x0){
+    if((int) x0.size() != matrixSize)
+        return false;
+    x = x0;
+    return true;
+}
+
+bool jacobiSolver::updateRHS(const vector<float> &newB){
+    if((int) newB.size() != matrixSize)
+        return false;
+    b = newB;
+    return true;
+}
+
+bool jacobiSolver::updateRHS(int i, float value){
+    if(i < 0 || i >= matrixSize)
+        return false;
+    b[i] = value;
+    return true;
+}
+
+bool jacobiSolver::updateRow(int i, const vector<float> &row){
+    if(i < 0 || i >= matrixSize || (int) row.size() != matrixSize)
+        return false;
+    A[i] = row;
+    diag[i] = row[i];
+    return true;
+}
+
+int jacobiSolver::solve(int maxIter, long *time){
+
+    int nrIter = maxIter;
+    utimer warm("Elapsed solver time = ", time);
+
+    for(int iter=0; iter<maxIter; iter++){
+        float norm = 0;
+        for(int i = 0; i < matrixSize; i++){
+            const vector<float> &row = A[i];
+            float sum = 0;
+            for(int j = 0; j < i; j++)
+                sum += row[j]*x[j];
+            for(int j = i+1; j < matrixSize; j++)
+                sum += row[j]*x[j];
+
+            tmp[i] = (b[i] - sum) / diag[i];
+            norm += abs(tmp[i] - x[i]);
+        }
+
+        //the new value becomes the starting point of the next iteration (and solve)
+        x.swap(tmp);
+
+        if(checkStoppingCriteria(norm / (float) matrixSize)){
+            nrIter = iter;
+            break;
+        }
+    }
+
+    return nrIter;
+}
+
+#endif // JACOBISOLVER_H
@@ -14,6 +14,9 @@
 
 #include "utimer.h"
 #include "utilities.h"
+#include "arena.h"
+#include "blockedKernel.h"
+#include "spinBarrier.h"
 
 using namespace std;
 
@@ -23,6 +26,18 @@ using namespace std;
  *        Get a square matrix and vector and compute the Jacobi method for determining
  *        the solution of a strictly diagonally dominant system of linear equation.
  *
+ *        The matrix is copied in a contiguous pooled buffer (see arena.h) and every
+ *        thread accumulates its partial norm in its own cache line. The sums of the rows
+ *        of each chunk are computed by the kernel of engineKernel(), the cache-blocked
+ *        kernel unless the autotuner chose another (see blockedKernel.h).
+ *
+ *        If given, onIteration is called at the end of every iteration from the barrier
+ *        callback, while the workers wait, with the norm of the iteration and the new
+ *        iterate (see checkpointJacobi.h).
+ *
+ *        The threads synchronize with std::barrier, or with a spin barrier (see
+ *        spinBarrier.h) when barrierType is "spin"; the autotuner chooses between them.
+ *
  *        During the execution, calculate and store the time to perform the algorithm.
  *
  * @param maxIter maximum number of iterations
@@ -31,9 +46,14 @@ using namespace std;
  * @param A matrix
  * @param b vector
  * @param time variable to store parallel time
+ * @param x0 initial guess, zero if empty
+ * @param onIteration function called after every iteration
+ * @param barrierType "std" or "spin"
  * @return solution of Jacobi algorithm (last computation)
  */
-vector<float> parallelJacobi(int maxIter, int matrixSize, int n_threads, vector<vector<float>> A, vector<float> b, long *time);
+vector<float> parallelJacobi(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time,
+                             const vector<float> &x0 = {}, const function<void(float, const float *)> &onIteration = nullptr,
+                             const string &barrierType = "std");
 
 /**
  * @brief Base function that perform a parallel version of Jacobi algorithm with barriers using pinned threads.
@@ -51,7 +71,7 @@ vector<float> parallelJacobi(int maxIter, int matrixSize, int n_threads, vector<
  * @param time variable to store parallel time
  * @return solution of Jacobi algorithm (last computation)
  */
-vector<float> parallelJacobiPinned(int maxIter, int matrixSize, int n_threads, vector<vector<float>> A, vector<float> b, long *time);
+vector<float> parallelJacobiPinned(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time);
 
 /**
  * @brief Base function that computes overhead of a parallel version of Jacobi algorithm with barrier.
@@ -63,48 +83,60 @@ vector<float> parallelJacobiPinned(int maxIter, int matrixSize, int n_threads, v
  */
 long computingOverhead(int maxIter, int matrixSize, int n_threads);
 
-vector<float> parallelJacobi(int maxIter, int matrixSize, int n_threads, vector<vector<float>> A, vector<float> b, long *time){
+/**
+ * @brief Body of parallelJacobi for a barrier type (std::barrier or spinBarrier).
+ */
+template<template<typename> class Barrier>
+vector<float> parallelJacobiWith(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time,
+                                 const vector<float> &x0, const function<void(float, const float *)> &onIteration){
 
-    vector<float> old_value(matrixSize, 0);     //previous value of the computation
+    arenaMatrix M(A);                           //contiguous copy of the matrix
+    arenaBuffer old_value(matrixSize);          //previous value of the computation
     vector<float> new_value(matrixSize, 0);     //new value of the computation
+    if(!x0.empty()){
+        copy(x0.begin(), x0.end(), old_value.data());
+        new_value = x0;
+    }
+    arenaBuffer rowSum(matrixSize);             //off-diagonal sums of the rows
 
     int NrIter=maxIter;
     float sum_norm = 0;
-    vector<float> norm(n_threads, 0);	//vector of the partial norms
+    const int NORM_STRIDE = CACHE_LINE / sizeof(float);
+    arenaBuffer norm(n_threads * NORM_STRIDE);	//partial norms, one cache line per thread
 
     //barrier callback
-    barrier barObj(n_threads, [&](){
+    auto completion = [&](){
     	//sum the partial norms
         for(int i=0; i < n_threads; i++){
-            sum_norm += norm[i];
-            norm[i]=0;
+            sum_norm += norm[i * NORM_STRIDE];
+            norm[i * NORM_STRIDE]=0;
         }
         sum_norm=sum_norm/((float)(matrixSize));
+        float iterNorm = sum_norm;
         if(checkStoppingCriteria(sum_norm))
             NrIter=0;
         else{
             NrIter--;
-            old_value=new_value;
+            copy(new_value.begin(), new_value.end(), old_value.data());
             sum_norm=0;
         }
+        if(onIteration)
+            onIteration(iterNorm, new_value.data());
         return;
-    });
+    };
+    Barrier<decltype(completion)> barObj(n_threads, completion);
 
     //thread lambda function
     auto sum=[&](int chunk_lower_bound, int chunk_upper_bound, int thread_i)	
     {
         while(NrIter>0){
-            for (int i=chunk_lower_bound; i<chunk_upper_bound; i++){
-                float sum=0;
-                for(int j=0; j<i; j++)
-                    sum += A[i][j]*old_value[j];
-                for(int j=i+1; j<matrixSize; j++)
-                    sum += A[i][j]*old_value[j];
+            rowSums(M, chunk_lower_bound, chunk_upper_bound, old_value.data(), rowSum.data() + chunk_lower_bound);
 
-                new_value[i]=(b[i]-sum)/A[i][i];
+            for (int i=chunk_lower_bound; i<chunk_upper_bound; i++){
+                new_value[i]=(b[i]-rowSum[i])/M.row(i)[i];
 
                 //compute partial norm
-                norm[thread_i]+=abs(old_value[i]-new_value[i]);
+                norm[thread_i * NORM_STRIDE]+=abs(old_value[i]-new_value[i]);
             }
             //call barrier
             barObj.arrive_and_wait();
@@ -137,27 +169,37 @@ vector<float> parallelJacobi(int maxIter, int matrixSize, int n_threads, vector<
     return new_value;
 }
 
-vector<float> parallelJacobiPinned(int maxIter, int matrixSize, int n_threads, vector<vector<float>> A, vector<float> b, long *time){
+vector<float> parallelJacobi(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time,
+                             const vector<float> &x0, const function<void(float, const float *)> &onIteration, const string &barrierType){
+    if(barrierType == "spin")
+        return parallelJacobiWith<spinBarrier>(maxIter, matrixSize, n_threads, A, b, time, x0, onIteration);
+    return parallelJacobiWith<barrier>(maxIter, matrixSize, n_threads, A, b, time, x0, onIteration);
+}
 
-    vector<float> old_value(matrixSize, 0);     //previous value of the computation
+vector<float> parallelJacobiPinned(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time){
+
+    arenaMatrix M(A);                           //contiguous copy of the matrix
+    arenaBuffer old_value(matrixSize);          //previous value of the computation
     vector<float> new_value(matrixSize, 0);     //new value of the computation
+    arenaBuffer rowSum(matrixSize);             //off-diagonal sums of the rows
 
     int NrIter=maxIter;
     float sum_norm = 0;
-    vector<float> norm(n_threads, 0);	//vector of the partial norms
+    const int NORM_STRIDE = CACHE_LINE / sizeof(float);
+    arenaBuffer norm(n_threads * NORM_STRIDE);	//partial norms, one cache line per thread
 
     //barrier lambda function
     barrier barObj(n_threads, [&](){
         for(int i=0; i < n_threads; i++){
-            sum_norm += norm[i];
-            norm[i]=0;
+            sum_norm += norm[i * NORM_STRIDE];
+            norm[i * NORM_STRIDE]=0;
         }
         sum_norm=sum_norm/((float)(matrixSize));
         if(checkStoppingCriteria(sum_norm))
             NrIter=0;
         else{
             NrIter--;
-            old_value=new_value;
+            copy(new_value.begin(), new_value.end(), old_value.data());
             sum_norm=0;
         }
         return;
@@ -180,17 +222,13 @@ vector<float> parallelJacobiPinned(int maxIter, int matrixSize, int n_threads, v
             std::cerr << "Error calling pthread_setaffinity_np: " << rc << "\n";
 
         while(NrIter>0){
-            for (int i=chunk_lower_bound; i<chunk_upper_bound; i++){
-                float sum=0;
-                for(int j=0; j<i; j++)
-                    sum += A[i][j]*old_value[j];
-                for(int j=i+1; j<matrixSize; j++)
-                    sum += A[i][j]*old_value[j];
+            rowSums(M, chunk_lower_bound, chunk_upper_bound, old_value.data(), rowSum.data() + chunk_lower_bound);
 
-                new_value[i]=(b[i]-sum)/A[i][i];
+            for (int i=chunk_lower_bound; i<chunk_upper_bound; i++){
+                new_value[i]=(b[i]-rowSum[i])/M.row(i)[i];
 
                 //compute partial norm
-                norm[thread_i]+=abs(old_value[i]-new_value[i]);
+                norm[thread_i * NORM_STRIDE]+=abs(old_value[i]-new_value[i]);
             }
             //call barrier
             barObj.arrive_and_wait();
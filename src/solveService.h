@@ -0,0 +1,365 @@
+#ifndef SOLVESERVICE_H
+#define SOLVESERVICE_H
+#include<stdlib.h>
+#include<iostream>
+#include<vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "utilities.h"
+#include "batchJacobi.h"
+
+using namespace std;
+
+/**
+ * @brief In-process service that solves concurrent Jacobi jobs on a shared worker pool.
+ *
+ *        Callers submit (A, b, tolerance) jobs and get a future of the solution. Jobs are
+ *        scheduled by priority and then by size (smaller first). The pool has a fixed number
+ *        of workers and never starts other threads:
+ *        - small jobs are popped in batches of up to maxBatch, and no more than the share
+ *          of the queue of one worker, and solved one after the other by a single worker
+ *          with solveSystem (fixed-size kernels included);
+ *        - a large job is led by one worker, the rows of every iteration are split in
+ *          chunks and the idle workers help the leader taking chunks from a shared counter.
+ *          Only one large job runs at a time, a higher priority small job is served
+ *          before helping; a higher priority large job waits, and the workers keep helping.
+ */
+class solveService {
+public:
+
+  /**
+   * @brief Counters of the service.
+   */
+  struct statistics {
+    size_t queueDepth;      //jobs waiting in the queue
+    size_t completed;       //jobs solved since the start
+    double throughput;      //jobs solved per second since the start
+    long p50;               //latency percentiles (usec) from submit to solution
+    long p95;
+    long p99;
+  };
+
+private:
+
+  using clock = chrono::steady_clock;
+
+  struct job {
+    int matrixSize;
+    int maxIter;
+    int priority;
+    double tolerance;
+    long seq;                   //submission order, to keep FIFO among equal jobs
+    vector<float> A;            //row-major matrix
+    vector<float> b;
+    promise<vector<float>> result;
+    clock::time_point submitted;
+  };
+
+  //higher priority first, then smaller systems, then older jobs
+  struct jobOrder {
+    bool operator()(const job *x, const job *y) const {
+      if(x->priority != y->priority) return x->priority < y->priority;
+      if(x->matrixSize != y->matrixSize) return x->matrixSize > y->matrixSize;
+      return x->seq > y->seq;
+    }
+  };
+
+  //large job shared by the leader and its helpers
+  struct gang {
+    job *j;
+    int nChunks;
+    int chunkSize;
+    int epoch;                  //iteration, changed under the service mutex
+    bool active;
+    int inside;                 //helpers currently working on the gang
+    atomic<int> nextChunk;
+    atomic<int> pending;        //chunks of the current iteration not finished yet
+    const float *old_value;
+    float *new_value;
+    vector<float> norms;        //partial norm of each chunk
+  };
+
+  int n_workers;
+  int largeThreshold;
+  int maxBatch;
+
+  mutex m;
+  condition_variable workCv;    //workers wait here for jobs or gang iterations
+  condition_variable gangCv;    //the leader waits here for the end of an iteration
+  priority_queue<job *, vector<job *>, jobOrder> queue;
+  gang *current;
+  long nextSeq;
+  bool stop;
+  vector<thread> workers;
+
+  //statistics
+  clock::time_point started;
+  size_t completed;
+  vector<long> latencies;       //last latencies, used as a ring buffer
+  size_t latencyPos;
+
+  void worker();
+  void solveSmall(job *j);
+  void solveLarge(job *j, unique_lock<mutex> &lock);
+  void runChunks(gang *g);
+  void finish(job *j, vector<float> &&x);
+
+public:
+
+  /**
+   * @param n_workers number of threads of the pool
+   * @param largeThreshold matrices of at least this size are split across workers
+   * @param maxBatch maximum number of small jobs a worker takes at once
+   */
+  solveService(int n_workers, int largeThreshold = 512, int maxBatch = 16);
+
+  /**
+   * @brief Solve the queued jobs and stop the workers.
+   */
+  ~solveService();
+
+  /**
+   * @brief Queue a job.
+   *
+   * @param A matrix
+   * @param b vector
+   * @param maxIter maximum number of iterations
+   * @param tolerance threshold of the stopping criterion
+   * @param priority jobs with higher priority are served first
+   * @return future of the solution
+   */
+  future<vector<float>> submit(const vector<vector<float>> &A, const vector<float> &b, int maxIter, double tolerance = EPSILON, int priority = 0);
+
+  /**
+   * @brief Snapshot of the counters of the service.
+   */
+  statistics stats();
+};
+
+solveService::solveService(int n_workers, int largeThreshold, int maxBatch)
+  : n_workers(max(1, n_workers)), largeThreshold(largeThreshold), maxBatch(max(1, maxBatch)),
+    current(NULL), nextSeq(0), stop(false), started(clock::now()), completed(0), latencies(), latencyPos(0) {
+    for(int i=0; i<this->n_workers; i++)
+        workers.emplace_back(&solveService::worker, this);
+}
+
+solveService::~solveService(){
+    {
+        lock_guard<mutex> lock(m);
+        stop = true;
+    }
+    workCv.notify_all();
+    for(thread &t : workers)
+        t.join();
+}
+
+future<vector<float>> solveService::submit(const vector<vector<float>> &A, const vector<float> &b, int maxIter, double tolerance, int priority){
+    job *j = new job;
+    j->matrixSize = b.size();
+    j->maxIter = maxIter;
+    j->priority = priority;
+    j->tolerance = tolerance;
+    j->A.resize((size_t) j->matrixSize * j->matrixSize);
+    for(int i=0; i<j->matrixSize; i++)
+        copy(A[i].begin(), A[i].begin() + j->matrixSize, j->A.begin() + (size_t) i * j->matrixSize);
+    j->b = b;
+    j->submitted = clock::now();
+    future<vector<float>> f = j->result.get_future();
+
+    {
+        lock_guard<mutex> lock(m);
+        j->seq = nextSeq++;
+        queue.push(j);
+    }
+    workCv.notify_one();
+    return f;
+}
+
+solveService::statistics solveService::stats(){
+    statistics s;
+    vector<long> sorted;
+    {
+        lock_guard<mutex> lock(m);
+        s.queueDepth = queue.size();
+        s.completed = completed;
+        s.throughput = completed / chrono::duration<double>(clock::now() - started).count();
+        sorted = latencies;
+    }
+
+    sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) -> long {
+        return sorted.empty() ? 0 : sorted[min(sorted.size() - 1, (size_t) (p * sorted.size()))];
+    };
+    s.p50 = percentile(0.50);
+    s.p95 = percentile(0.95);
+    s.p99 = percentile(0.99);
+    return s;
+}
+
+void solveService::finish(job *j, vector<float> &&x){
+    long us = chrono::duration_cast<chrono::microseconds>(clock::now() - j->submitted).count();
+    {
+        lock_guard<mutex> lock(m);
+        completed++;
+        const size_t window = 10000;
+        if(latencies.size() < window)
+            latencies.push_back(us);
+        else
+            latencies[latencyPos++ % window] = us;
+    }
+
+    j->result.set_value(move(x));
+    delete j;
+}
+
+void solveService::solveSmall(job *j){
+    vector<float> x(j->matrixSize, 0);
+    vector<float> tmp(j->matrixSize);
+    solveSystem(j->maxIter, j->matrixSize, j->A.data(), j->b.data(), x.data(), tmp.data(), j->tolerance);
+    finish(j, move(x));
+}
+
+void solveService::runChunks(gang *g){
+    const int n = g->j->matrixSize;
+    const float *A = g->j->A.data();
+    const float *b = g->j->b.data();
+
+    int c;
+    while((c = g->nextChunk.fetch_add(1, memory_order_acq_rel)) < g->nChunks){
+        const float *old_value = g->old_value;
+        float *new_value = g->new_value;
+        int lo = c * g->chunkSize;
+        int hi = min(lo + g->chunkSize, n);
+
+        float norm = 0;
+        for(int i=lo; i<hi; i++){
+            const float *row = A + (size_t) i * n;
+            float sum = 0;
+            for(int j=0; j<i; j++)
+                sum += row[j]*old_value[j];
+            for(int j=i+1; j<n; j++)
+                sum += row[j]*old_value[j];
+
+            new_value[i] = (b[i] - sum) / row[i];
+            norm += abs(old_value[i] - new_value[i]);
+        }
+        g->norms[c] = norm;
+
+        //the last chunk of the iteration wakes up the leader
+        if(g->pending.fetch_sub(1, memory_order_acq_rel) == 1){
+            lock_guard<mutex> lock(m);
+            gangCv.notify_all();
+        }
+    }
+}
+
+void solveService::solveLarge(job *j, unique_lock<mutex> &lock){
+    const int n = j->matrixSize;
+    vector<float> old_value(n, 0);     //previous value of the computation
+    vector<float> new_value(n, 0);     //new value of the computation
+
+    gang g;
+    g.j = j;
+    g.chunkSize = max(16, n / (4 * n_workers));
+    g.nChunks = (n + g.chunkSize - 1) / g.chunkSize;
+    g.epoch = 0;
+    g.active = true;
+    g.inside = 0;
+    g.nextChunk.store(g.nChunks);
+    g.pending.store(0);
+    g.norms.assign(g.nChunks, 0);
+    current = &g;
+
+    for(int iter=0; iter<j->maxIter; iter++){
+        //publish the iteration, then open the chunks to the helpers
+        g.old_value = old_value.data();
+        g.new_value = new_value.data();
+        g.pending.store(g.nChunks, memory_order_relaxed);
+        g.nextChunk.store(0, memory_order_release);
+        g.epoch++;
+        lock.unlock();
+        workCv.notify_all();
+
+        runChunks(&g);
+
+        lock.lock();
+        gangCv.wait(lock, [&](){ return g.pending.load(memory_order_acquire) == 0; });
+
+        float norm = 0;
+        for(int c=0; c<g.nChunks; c++)
+            norm += g.norms[c];
+        if(checkStoppingCriteria(norm / (float) n, j->tolerance))
+            break;
+        old_value.swap(new_value);
+    }
+
+    //wait for the helpers still inside before the gang goes out of scope
+    g.active = false;
+    gangCv.wait(lock, [&](){ return g.inside == 0; });
+    current = NULL;
+    lock.unlock();
+    workCv.notify_all();
+
+    finish(j, move(new_value));
+    lock.lock();
+}
+
+void solveService::worker(){
+    long lastJob = -1;          //large job and iteration helped last time
+    int lastEpoch = 0;
+
+    unique_lock<mutex> lock(m);
+    while(true){
+        gang *g = current;
+        bool newIteration = g != NULL && g->active && (g->j->seq != lastJob || g->epoch != lastEpoch);
+        bool urgent = !queue.empty() && (g == NULL || queue.top()->priority > g->j->priority);
+        bool canPop = !queue.empty() && (g == NULL || queue.top()->matrixSize < largeThreshold);
+
+        if(newIteration && !(urgent && canPop)){
+            //help the leader with the chunks of this iteration (also when the urgent job is large and must wait)
+            lastJob = g->j->seq;
+            lastEpoch = g->epoch;
+            g->inside++;
+            lock.unlock();
+            runChunks(g);
+            lock.lock();
+            g->inside--;
+            gangCv.notify_all();
+        }
+        else if(canPop){
+            //share the queued jobs among the workers instead of batching them all on this one
+            int batchSize = min(maxBatch, max(1, (int) queue.size() / n_workers));
+            job *j = queue.top();
+            queue.pop();
+            if(j->matrixSize >= largeThreshold){
+                solveLarge(j, lock);
+                continue;
+            }
+
+            //take a batch of small jobs
+            vector<job *> batch(1, j);
+            while((int) batch.size() < batchSize && !queue.empty() && queue.top()->matrixSize < largeThreshold){
+                batch.push_back(queue.top());
+                queue.pop();
+            }
+            lock.unlock();
+            for(job *s : batch)
+                solveSmall(s);
+            lock.lock();
+        }
+        else if(stop && queue.empty() && current == NULL)
+            return;
+        else
+            workCv.wait(lock);
+    }
+}
+
+#endif // SOLVESERVICE_H
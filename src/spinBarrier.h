@@ -0,0 +1,50 @@
+#ifndef SPINBARRIER_H
+#define SPINBARRIER_H
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Empty completion function of spinBarrier.
+ */
+struct noCompletion {
+  void operator()() const {}
+};
+
+/**
+ * @brief Sense-reversing spin barrier with a completion function, alternative to std::barrier.
+ *
+ *        The last thread to arrive runs the completion function and then releases the
+ *        others, which spin (yielding the core) on the sense flag instead of sleeping in
+ *        the kernel. Same interface of std::barrier for arrive_and_wait.
+ */
+template<typename Completion = noCompletion>
+class spinBarrier {
+  const int n;
+  atomic<int> count;
+  atomic<int> sense;
+  Completion completion;
+
+public:
+
+  /**
+   * @param n number of threads
+   * @param completion function run by the last thread of every phase
+   */
+  spinBarrier(int n, Completion completion = Completion()) : n(n), count(0), sense(0), completion(completion) {}
+
+  void arrive_and_wait(){
+    int s = sense.load(memory_order_acquire);
+    if(count.fetch_add(1, memory_order_acq_rel) + 1 == n){
+        completion();
+        count.store(0, memory_order_relaxed);
+        sense.store(s ^ 1, memory_order_release);
+    }
+    else
+        while(sense.load(memory_order_acquire) == s)
+            this_thread::yield();
+  }
+};
+
+#endif // SPINBARRIER_H
@@ -0,0 +1,95 @@
+#ifndef STDPARJACOBI_H
+#define STDPARJACOBI_H
+
+#include<stdlib.h>
+#include<iostream>
+#include<vector>
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <numeric>
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#define STDPAR_TBB
+#endif
+
+#include "utimer.h"
+#include "utilities.h"
+#include "arena.h"
+#include "blockedKernel.h"
+
+using namespace std;
+
+/**
+ * @brief Base function that perform a parallel version of Jacobi algorithm with the C++ parallel algorithms.
+ *
+ *        Get a square matrix and vector and compute the Jacobi method for determining
+ *        the solution of a strictly diagonally dominant system of linear equation.
+ *
+ *        The rows are split in blocks and every iteration is a single transform_reduce
+ *        with the par_unseq policy: each block computes its row sums with the row kernel
+ *        of engineKernel() (see blockedKernel.h), its new values and returns its partial norm, so the
+ *        update and the norm take one pass. The iterate is copied back with a parallel copy.
+ *        The library decides the threads: with the TBB backend of libstdc++ their number
+ *        is limited to n_threads, without TBB the algorithms run sequentially. The partial
+ *        norms are added in the order chosen by the library, so the number of iterations
+ *        may differ by one from the other engines.
+ *
+ *        During the execution, calculate and store the time to perform the algorithm.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of matrix (nxn)
+ * @param n_threads number of threads
+ * @param A matrix
+ * @param b vector
+ * @param time variable to store the parallel algorithms time
+ * @return solution of Jacobi algorithm (last computation)
+ */
+vector<float> stdparJacobi(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time);
+
+vector<float> stdparJacobi(int maxIter, int matrixSize, int n_threads, const vector<vector<float>> &A, const vector<float> &b, long *time){
+
+    arenaMatrix M(A);                              //contiguous copy of the matrix
+    arenaBuffer old_value(matrixSize);             //previous value of the computation
+    vector<float> new_value(matrixSize, 0);        //new value of the computation
+    arenaBuffer rowSum(matrixSize);                //off-diagonal sums of the rows
+
+#ifdef STDPAR_TBB
+    //limit the workers of the TBB backend for the lifetime of the solve
+    tbb::global_control workers(tbb::global_control::max_allowed_parallelism, n_threads);
+#endif
+
+    //first row of every block, a few blocks per thread to balance the load
+    int n_block = max(16, matrixSize / (4 * n_threads));
+    vector<int> blocks;
+    for(int i=0; i<matrixSize; i+=n_block)
+        blocks.push_back(i);
+
+    {
+        utimer stdpar("Elapsed parallel algorithms time = ", time);
+
+        for(int k=0; k<maxIter; k++){
+            //update the rows of each block and reduce the partial norms
+            float norm = transform_reduce(execution::par_unseq, blocks.begin(), blocks.end(), 0.0f, plus<float>(), [&](int start){
+                int stop = min(start + n_block, matrixSize);
+                rowSums(M, start, stop, old_value.data(), rowSum.data() + start);
+
+                float partial = 0;
+                for(int i=start; i<stop; i++){
+                    new_value[i]=(b[i]-rowSum[i])/M.row(i)[i];
+                    partial += abs(old_value[i] - new_value[i]);
+                }
+                return partial;
+            });
+
+            //check stopping criterion to stop the algorithm
+            if(checkStoppingCriteria(norm / (float) matrixSize))
+                break;
+            else
+                copy(execution::par_unseq, new_value.begin(), new_value.end(), old_value.data());
+        }
+    }
+
+    return new_value;
+}
+#endif // STDPARJACOBI_H
@@ -0,0 +1,238 @@
+#ifndef SYMMETRICJACOBI_H
+#define SYMMETRICJACOBI_H
+#include<stdlib.h>
+#include<iostream>
+#include<vector>
+#include <thread>
+#include <barrier>
+
+#include "utimer.h"
+#include "utilities.h"
+#include "arena.h"
+
+using namespace std;
+
+/**
+ * @brief Symmetric matrix stored as its packed upper triangle.
+ *
+ *        Row i keeps the entries (i, i), (i, i+1), ..., (i, n-1) one after the other,
+ *        so the matrix takes n(n+1)/2 floats instead of n^2.
+ */
+class symPackedMatrix {
+  int n;
+  arenaBuffer packed;
+
+public:
+
+  /**
+   * @brief Pack the upper triangle of a symmetric matrix.
+   * @param A symmetric matrix
+   */
+  symPackedMatrix(const vector<vector<float>> &A);
+
+  /**
+   * @brief Pointer to the entry (i, i), followed by the entries (i, j) with j > i.
+   */
+  const float *row(int i) const { return packed.data() + (size_t) i * n - (size_t) i * (i - 1) / 2; }
+
+  int size() const { return n; }
+
+  /**
+   * @brief Number of stored floats.
+   */
+  size_t storage() const { return (size_t) n * (n + 1) / 2; }
+};
+
+/**
+ * @brief Sequential version of Jacobi algorithm on a packed symmetric matrix.
+ *
+ *        Every stored entry a_ij (j > i) is read once per iteration and used for both
+ *        row i (a_ij * x_j) and row j (a_ji * x_i = a_ij * x_i).
+ *
+ *        During the execution, calculate and store the time to perform the algorithm
+ *        and the number of iterations done.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of matrix (nxn)
+ * @param A packed symmetric matrix
+ * @param b vector
+ * @param time variable to store sequential time
+ * @param nrIter number of iterations done
+ * @return solution of Jacobi algorithm (last computation)
+ */
+vector<float> seqSymJacobi(int maxIter, int matrixSize, const symPackedMatrix &A, const vector<float> &b, long *time, int *nrIter);
+
+/**
+ * @brief Parallel version of Jacobi algorithm with barriers on a packed symmetric matrix.
+ *
+ *        The rows of the upper triangle are split so that every thread gets about the same
+ *        number of stored entries. Each thread accumulates the contributions of its rows in
+ *        a private buffer of length n (so no two threads write the same sum); after a
+ *        barrier every thread reduces the private buffers on a range of rows, computes the
+ *        new value and the partial norm of those rows and clears the buffers for the next
+ *        iteration.
+ *
+ *        During the execution, calculate and store the time to perform the algorithm.
+ *
+ * @param maxIter maximum number of iterations
+ * @param matrixSize dimension of matrix (nxn)
+ * @param n_threads number of threads
+ * @param A packed symmetric matrix
+ * @param b vector
+ * @param time variable to store parallel time
+ * @return solution of Jacobi algorithm (last computation)
+ */
+vector<float> parallelSymJacobi(int maxIter, int matrixSize, int n_threads, const symPackedMatrix &A, const vector<float> &b, long *time);
+
+symPackedMatrix::symPackedMatrix(const vector<vector<float>> &A) : n(A.size()), packed((size_t) A.size() * (A.size() + 1) / 2) {
+    for(int i=0; i<n; i++){
+        float *r = packed.data() + (size_t) i * n - (size_t) i * (i - 1) / 2;
+        for(int j=i; j<n; j++)
+            r[j - i] = A[i][j];
+    }
+}
+
+vector<float> seqSymJacobi(int maxIter, int matrixSize, const symPackedMatrix &A, const vector<float> &b, long *time, int *nrIter){
+
+    arenaBuffer old_value(matrixSize);             //previous value of the computation
+    vector<float> new_value(matrixSize, 0);        //new value of the computation
+    arenaBuffer sum(matrixSize);                   //off-diagonal sums of the rows
+
+    utimer seq("Elapsed symmetric sequential time = ", time);
+
+    for(int iter=0; iter<maxIter; iter++){
+        for(int i = 0; i < matrixSize; i++){
+            const float *row = A.row(i);
+            const float xi = old_value[i];
+            float si = 0;
+            for(int j = i+1; j < matrixSize; j++){
+                si += row[j - i]*old_value[j];
+                sum[j] += row[j - i]*xi;
+            }
+            sum[i] += si;
+        }
+
+        float norm = 0;
+        for(int i = 0; i < matrixSize; i++){
+            new_value[i] = (b[i] - sum[i]) / A.row(i)[0];
+            norm += abs(old_value[i] - new_value[i]);
+            sum[i] = 0;
+        }
+
+        //check stopping criterion to stop the algorithm and save the number of iterations done
+        if(checkStoppingCriteria(norm / (float) matrixSize)){
+            *nrIter = iter;
+            break;
+        }
+        else
+            copy(new_value.begin(), new_value.end(), old_value.data());
+    }
+
+    return new_value;
+}
+
+vector<float> parallelSymJacobi(int maxIter, int matrixSize, int n_threads, const symPackedMatrix &A, const vector<float> &b, long *time){
+
+    arenaBuffer old_value(matrixSize);          //previous value of the computation
+    vector<float> new_value(matrixSize, 0);     //new value of the computation
+
+    //private accumulators, each one starts on its own cache line
+    const size_t stride = (matrixSize + CACHE_LINE / sizeof(float) - 1) / (CACHE_LINE / sizeof(float)) * (CACHE_LINE / sizeof(float));
+    arenaBuffer acc(n_threads * stride);
+
+    int NrIter=maxIter;
+    float sum_norm = 0;
+    const int NORM_STRIDE = CACHE_LINE / sizeof(float);
+    arenaBuffer norm(n_threads * NORM_STRIDE);	//partial norms, one cache line per thread
+
+    //rows of the triangle of each thread, balanced on the number of stored entries
+    vector<int> triBound(n_threads + 1, matrixSize);
+    triBound[0] = 0;
+    {
+        double total = (double) matrixSize * (matrixSize + 1) / 2;
+        double done = 0;
+        int t = 1;
+        for(int i=0; i<matrixSize && t<n_threads; i++){
+            done += matrixSize - i;
+            if(done >= total * t / n_threads)
+                triBound[t++] = i + 1;
+        }
+    }
+
+    //accumulation done, start the reduction
+    barrier accumulated(n_threads);
+
+    //barrier callback
+    barrier barObj(n_threads, [&](){
+    	//sum the partial norms
+        for(int i=0; i < n_threads; i++){
+            sum_norm += norm[i * NORM_STRIDE];
+            norm[i * NORM_STRIDE]=0;
+        }
+        sum_norm=sum_norm/((float)(matrixSize));
+        if(checkStoppingCriteria(sum_norm))
+            NrIter=0;
+        else{
+            NrIter--;
+            copy(new_value.begin(), new_value.end(), old_value.data());
+            sum_norm=0;
+        }
+        return;
+    });
+
+    //thread lambda function
+    auto sum=[&](int tri_lower_bound, int tri_upper_bound, int chunk_lower_bound, int chunk_upper_bound, int thread_i)
+    {
+        float *myAcc = acc.data() + thread_i * stride;
+
+        while(NrIter>0){
+            //accumulate both contributions of every stored entry of the rows of the thread
+            for(int i=tri_lower_bound; i<tri_upper_bound; i++){
+                const float *row = A.row(i);
+                const float xi = old_value[i];
+                float si = 0;
+                for(int j=i+1; j<matrixSize; j++){
+                    si += row[j - i]*old_value[j];
+                    myAcc[j] += row[j - i]*xi;
+                }
+                myAcc[i] += si;
+            }
+            accumulated.arrive_and_wait();
+
+            //reduce the private buffers on the chunk of the thread
+            for(int i=chunk_lower_bound; i<chunk_upper_bound; i++){
+                float s = 0;
+                for(int t=0; t<n_threads; t++){
+                    s += acc[t * stride + i];
+                    acc[t * stride + i] = 0;
+                }
+                new_value[i] = (b[i] - s) / A.row(i)[0];
+
+                //compute partial norm
+                norm[thread_i * NORM_STRIDE] += abs(old_value[i] - new_value[i]);
+            }
+            //call barrier
+            barObj.arrive_and_wait();
+        }
+    };
+
+    vector<thread> t;
+    int n_chunk;    //chunks size of the reduction
+    n_chunk =  matrixSize % n_threads == 0  ? (matrixSize / n_threads) : (matrixSize / n_threads) + 1;
+
+    //main loop
+    {
+        utimer threadtime("Elapsed symmetric thread time = ", time);
+
+        for(int thread_i=0; thread_i<n_threads; thread_i++)
+            t.emplace_back(sum, triBound[thread_i], triBound[thread_i + 1],
+                           min(thread_i * n_chunk, matrixSize), min((thread_i + 1) * n_chunk, matrixSize), thread_i);
+
+        for(int i=0; i<n_threads; i++)
+            t[i].join();
+    }
+
+    return new_value;
+}
+
+#endif // SYMMETRICJACOBI_H
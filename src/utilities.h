@@ -54,6 +54,13 @@ float scalability(long tpar1, long tparn);
 */
 vector<vector<float>> matrixGenerator(int size);
 
+/**
+* @brief Generate a random symmetric sizexsize matrix
+* @param size dimension of matrix (nxn)
+* @return a float random symmetric, strongly diagonally dominant, square matrix sizexsize.
+*/
+vector<vector<float>> symmetricMatrixGenerator(int size);
+
 /**
 * @brief Generate a random right side vector
 * @param size dimension of vector (n)
@@ -104,6 +111,17 @@ bool checkStoppingCriteria(float norm){
     return (norm <= EPSILON);
 }
 
+/**
+ * @brief Check if the algorithm reached the stopping criterion with a given tolerance.
+ *
+ * @param norm matrix norm
+ * @param tolerance threshold of the norm
+ * @return a boolean value that shows if the stopping criterion occurs
+ */
+bool checkStoppingCriteria(float norm, double tolerance){
+    return (norm <= tolerance);
+}
+
 vector<vector<float>> matrixGenerator(int size){
 
     vector<vector<float>> M(size, vector<float>(size, 0));
@@ -122,6 +140,26 @@ vector<vector<float>> matrixGenerator(int size){
     return M;
 }
 
+vector<vector<float>> symmetricMatrixGenerator(int size){
+
+    vector<vector<float>> M(size, vector<float>(size, 0));
+
+    for (int i=0; i<size; i++)
+        for(int j=i+1; j<size; j++){
+            M[i][j] = MIN_VALUE + static_cast<float>(rand()) * static_cast<float>(MAX_VALUE - MIN_VALUE) / RAND_MAX;
+            M[j][i] = M[i][j];
+        }
+
+    //strongly diagonal dominant
+    for (int i=0; i<size; i++){
+        float sum=0.0;
+        for(int j=0; j<size; j++)
+            sum+=M[i][j];
+        M[i][i]=((float)2*sum);
+    }
+    return M;
+}
+
 vector<float> RHSVectorGenerator(int size){
     vector<float> b(size);
     for(int i=0; i<size; i++)